@@ -11,6 +11,9 @@
 //#include "probancestrygraphyoshiko.h"
 #include "probancestrygraph.h"
 #include <cmath>
+#include <sstream>
+#include <cstring>
+#include <cctype>
 
 #include <fstream>
 
@@ -18,7 +21,8 @@ using namespace vaff;
 
 void printUsage(const char* argv0, std::ostream& out)
 {
-  out << "Usage: " << argv0 << " <READ_COUNTS> <ANCESTRY_MATRIX> <ALPHA> <BETA> <GAMMA> <TYPE> (<IDX>) where" << std::endl
+  out << "Usage: " << argv0 << " <READ_COUNTS> <ANCESTRY_MATRIX> <ALPHA> <BETA> <GAMMA> <TYPE> (<IDX>)" << std::endl
+      << "       " << argv0 << " <READ_COUNTS> <ANCESTRY_MATRIX> <ALPHA> <BETA> <GAMMA> --metrics <TYPE>,<TYPE>,... (--format tsv|json) (<IDX>) where" << std::endl
       << "  <READ_COUNTS>      is the read count matrix file" << std::endl
       << "  <ANCESTRY_MATRIX>  is the ancestry matrix file" << std::endl
       << "  <ALPHA>            alpha parameter (ancestry)" << std::endl
@@ -46,93 +50,29 @@ void printUsage(const char* argv0, std::ostream& out)
          "                     18: sample alpha and output #clusters\n"
          "                     19: sample beta (given alpha) and output #edges\n"
          "                     20: show (1-gamma) confidence intervals" << std::endl
-      << "  <IDX>              SCC index" << std::endl;
+      << "  <IDX>              SCC index" << std::endl
+      << "  --metrics          comma-separated list of types, all computed on the same G, H and CI" << std::endl
+      << "  --format           output format of --metrics: tsv (default) or json" << std::endl;
 }
 
-int main(int argc, char** argv)
+bool analyse(int type,
+             int idx,
+             double gamma,
+             const ReadCountMatrix& R,
+             const AncestryMatrix& A,
+             const ProbAncestryGraph& G,
+             const StlIntMatrix& toOrginalColumns,
+             const ReadCountMatrix& newR,
+             const RealIntervalMatrix& CI,
+             const ProbAncestryGraph& H,
+             std::ostream& out)
 {
-  if (argc != 7 && argc != 8)
-  {
-    printUsage(argv[0], std::cerr);
-    return 1;
-  }
-  
-  double alpha = -1;
-  sscanf(argv[3], "%lf", &alpha);
-  if (!(0 <= alpha && alpha <= 0.5))
-  {
-    std::cerr << "Error: alpha must be in [0,0.5]" << std::endl;
-    return 1;
-  }
-  
-  double beta = -1;
-  sscanf(argv[4], "%lf", &beta);
-  if (!(0.5 <= beta && beta <= 1))
-  {
-    std::cerr << "Error: beta must be in [0.5,1]" << std::endl;
-    return 1;
-  }
-  
-  double gamma = -1;
-  sscanf(argv[5], "%lf", &gamma);
-  if (!(0 <= gamma && gamma <= 1))
-  {
-    std::cerr << "Error: gamma must be in [0,1]" << std::endl;
-    return 1;
-  }
-  
-  AncestryMatrix A;
-  std::string filename_ancestry_matrix = argv[2];
-  
-  if (filename_ancestry_matrix != "-")
-  {
-    std::ifstream in(filename_ancestry_matrix.c_str());
-    if (!in.good())
-    {
-      std::cerr << "Error: failed to open '" << filename_ancestry_matrix << "' for reading" << std::endl;
-      return 1;
-    }
-    in >> A;
-    in.close();
-  }
-
-  ReadCountMatrix R;
-  std::string read_count_matrix = argv[1];
-  
-  if (read_count_matrix != "-")
-  {
-    std::ifstream in(read_count_matrix.c_str());
-    if (!in.good())
-    {
-      std::cerr << "Error: failed to open '" << read_count_matrix << "' for reading" << std::endl;
-      return 1;
-    }
-    in >> R;
-    in.close();
-  }
-  
-  //ProbAncestryGraphYoshiko G(A, R, alpha, gamma);
-  ProbAncestryGraph G(A, R, alpha, gamma);
-  
-  StlIntMatrix toOrginalColumns;
-  G.removeCycles(A, alpha, toOrginalColumns);
-
-  ReadCountMatrix newR = R.collapse(toOrginalColumns);
-  newR.remapLabels(toOrginalColumns, R);
-  RealIntervalMatrix CI;
-  newR.computeConfidenceIntervals(CI, gamma);
-  
-  ProbAncestryGraph H;
-  G.contract(A, toOrginalColumns, beta, H);
-//  H.writeDOT(newR, CI, std::cout);
-  
-  int type = atoi(argv[6]);
   switch(type)
   {
     case 0:
-      std::cout << H.numberOfNodesInDeg0() << "\t"
-                << G.numberOfNodesInfCI() << "\t"
-                << H.largestArborescence() << std::endl;
+      out << H.numberOfNodesInDeg0() << "\t"
+          << G.numberOfNodesInfCI() << "\t"
+          << H.largestArborescence() << std::endl;
       break;
     case 1:
       {
@@ -142,7 +82,7 @@ int main(int argc, char** argv)
         ProbAncestryGraph::printIntraClusterCoherence(H.getG(),
                                                       H.getNodeToColumnMap(),
                                                       label,
-                                                      A, std::cout);
+                                                      A, out);
         
         ProbAncestryGraph::printClusterSize(toOrginalColumns, std::cerr);
       }
@@ -155,48 +95,47 @@ int main(int argc, char** argv)
         ProbAncestryGraph::printInterClusterCoherence(H.getG(),
                                                       H.getNodeToColumnMap(),
                                                       label,
-                                                      A, std::cout);
+                                                      A, out);
       }
       break;
     case 3:
-//      std::cout << G.numberOfNodesInfCI() << "\t" << G.isDAG() << std::endl;
-      std::cout << G.isDAG() << std::endl;
+//      out << G.numberOfNodesInfCI() << "\t" << G.isDAG() << std::endl;
+      out << G.isDAG() << std::endl;
       break;
     case 4:
-      std::cout << G.numberOfNonTrivialSCC() << std::endl;
+      out << G.numberOfNonTrivialSCC() << std::endl;
       break;
     case 5:
-      std::cout << G.isTransitive() << std::endl;
+      out << G.isTransitive() << std::endl;
       break;
     case 6:
-      std::cout << H.isDAG() << std::endl;
+      out << H.isDAG() << std::endl;
       break;
     case 7:
       {
         int i = 0;
         for (StlIntMatrixIt it = toOrginalColumns.begin(); it != toOrginalColumns.end(); ++it, ++i)
         {
-          std::cout << i << ": " << it->size() << std::endl;
+          out << i << ": " << it->size() << std::endl;
         }
       }
       break;
     case 8:
-      if (argc != 8)
+      if (idx == -1)
       {
-        printUsage(argv[0], std::cerr);
-        return 1;
+        std::cerr << "Error: type 8 requires <IDX>" << std::endl;
+        return false;
       }
       else
       {
-        int idx = atoi(argv[7]);
         if (0 <= idx && idx < toOrginalColumns.size())
         {
-          G.writeDOT(R, toOrginalColumns[idx], std::cout);
+          G.writeDOT(R, toOrginalColumns[idx], out);
         }
         else
         {
           std::cerr << "Invalid SCC index" << std::endl;
-          return 1;
+          return false;
         }
       }
       break;
@@ -205,76 +144,74 @@ int main(int argc, char** argv)
         int n_square = A.getNrRows() * A.getNrRows();
         int anti_count = A.antiSymmetricElements();
         double f = (float)anti_count / (float)n_square;
-        std::cout << f << ",";
+        out << f << ",";
       }
       {
         int totalCount;
         int antiCount;
         A.antiSymmetricElements(toOrginalColumns, antiCount, totalCount);
         double f = (float)antiCount / (float)totalCount;
-        std::cout << f << std::endl;
+        out << f << std::endl;
       }
       break;
     case 10:
-      if (argc != 8)
+      if (idx == -1)
       {
-        printUsage(argv[0], std::cerr);
-        return 1;
+        std::cerr << "Error: type 10 requires <IDX>" << std::endl;
+        return false;
       }
       else
       {
-        int idx = atoi(argv[7]);
         if (0 <= idx && idx < toOrginalColumns.size())
         {
           int n_square = toOrginalColumns[idx].size();
           n_square *= n_square;
           int anti_count = A.antiSymmetricElements(toOrginalColumns[idx]);
           double f = (float)anti_count / (float)n_square;
-          std::cout << anti_count << "/" << n_square << " = " << f << std::endl;
+          out << anti_count << "/" << n_square << " = " << f << std::endl;
         }
         else
         {
           std::cerr << "Invalid SCC index" << std::endl;
-          return 1;
+          return false;
         }
       }
       break;
     case 11:
-      A.writeAntiSymmetricElements(R, std::cout);
+      A.writeAntiSymmetricElements(R, out);
       break;
     case 12:
-      A.writeAntiSymmetricElements(R, toOrginalColumns, std::cout);
+      A.writeAntiSymmetricElements(R, toOrginalColumns, out);
     case 13:
-      if (argc != 8)
+      if (idx == -1)
       {
-        printUsage(argv[0], std::cerr);
-        return 1;
+        std::cerr << "Error: type 13 requires <IDX>" << std::endl;
+        return false;
       }
       else
       {
-        int idx = atoi(argv[7]);
         if (0 <= idx && idx < toOrginalColumns.size())
         {
-          A.writeAntiSymmetricElements(R, toOrginalColumns[idx], std::cout);
+          A.writeAntiSymmetricElements(R, toOrginalColumns[idx], out);
         }
         else
         {
           std::cerr << "Invalid SCC index" << std::endl;
-          return 1;
+          return false;
         }
       }
       break;
     case 14:
-//      G.writeYoshiko(A, R, alpha, std::cout);
+//      G.writeYoshiko(A, R, alpha, out);
       break;
     case 15:
-      G.writeDOT(R, toOrginalColumns, std::cout);
+      G.writeDOT(R, toOrginalColumns, out);
       break;
     case 16:
-      std::cout << R.coverage() << std::endl;
+      out << R.coverage() << std::endl;
       break;
     case 17:
-      H.writeDOT(newR, std::cout);
+      H.writeDOT(newR, out);
       H.isDAG();
       break;
     case 18:
@@ -285,9 +222,9 @@ int main(int argc, char** argv)
         StlIntMatrix toOrginalColumns2;
         GG.removeCycles(A, a, toOrginalColumns2);
         
-        std::cout << "," << toOrginalColumns2.size();
+        out << "," << toOrginalColumns2.size();
       }
-      std::cout << std::endl;
+      out << std::endl;
       break;
     case 19:
       for (double b = 0.5; b <= 1; b += 0.01)
@@ -295,18 +232,323 @@ int main(int argc, char** argv)
         ProbAncestryGraph HH;
         G.contract(A, toOrginalColumns, b, HH);
         
-        std::cout << "," << lemon::countArcs(HH.getG());
+        out << "," << lemon::countArcs(HH.getG());
       }
-      std::cout << std::endl;
+      out << std::endl;
       break;
     case 20:
-      std::cout << CI;
-      std::cout << newR;
+      out << CI;
+      out << newR;
       break;
     default:
       std::cerr << "Invalid type" << std::endl;
+      return false;
+  }
+  
+  return true;
+}
+
+bool parseMetrics(const std::string& str, StlIntVector& types)
+{
+  types.clear();
+  
+  std::stringstream ss(str);
+  std::string token;
+  while (std::getline(ss, token, ','))
+  {
+    if (token.empty())
+    {
+      continue;
+    }
+    
+    char* end = NULL;
+    long type = strtol(token.c_str(), &end, 10);
+    if (*end != '\0' || type < 0)
+    {
+      return false;
+    }
+    types.push_back(type);
+  }
+  
+  return !types.empty();
+}
+
+bool isJsonNumber(const std::string& str)
+{
+  // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?, which excludes nan and inf
+  const size_t n = str.size();
+  size_t i = 0;
+  if (i < n && str[i] == '-')
+  {
+    ++i;
+  }
+  if (i == n || !isdigit(str[i]))
+  {
+    return false;
+  }
+  if (str[i] == '0')
+  {
+    ++i;
+  }
+  else
+  {
+    while (i < n && isdigit(str[i]))
+    {
+      ++i;
+    }
+  }
+  if (i < n && str[i] == '.')
+  {
+    ++i;
+    if (i == n || !isdigit(str[i]))
+    {
+      return false;
+    }
+    while (i < n && isdigit(str[i]))
+    {
+      ++i;
+    }
+  }
+  if (i < n && (str[i] == 'e' || str[i] == 'E'))
+  {
+    ++i;
+    if (i < n && (str[i] == '+' || str[i] == '-'))
+    {
+      ++i;
+    }
+    if (i == n || !isdigit(str[i]))
+    {
+      return false;
+    }
+    while (i < n && isdigit(str[i]))
+    {
+      ++i;
+    }
+  }
+  return i == n;
+}
+
+std::string escape(const std::string& str, bool json)
+{
+  std::string res;
+  for (std::string::const_iterator it = str.begin(); it != str.end(); ++it)
+  {
+    switch (*it)
+    {
+      case '\n':
+        res += "\\n";
+        break;
+      case '\t':
+        res += "\\t";
+        break;
+      case '\\':
+        res += "\\\\";
+        break;
+      case '"':
+        res += json ? "\\\"" : "\"";
+        break;
+      default:
+        res += *it;
+    }
+  }
+  return res;
+}
+
+// non-finite numbers have no JSON representation
+std::string jsonValue(const std::string& str)
+{
+  if (isJsonNumber(str))
+  {
+    return str;
+  }
+  
+  char* end = NULL;
+  double value = strtod(str.c_str(), &end);
+  if (!str.empty() && *end == '\0' && !std::isfinite(value))
+  {
+    return "null";
+  }
+  
+  return "\"" + escape(str, true) + "\"";
+}
+
+int main(int argc, char** argv)
+{
+  std::vector<char*> args;
+  std::string metrics;
+  std::string format = "tsv";
+  bool multi = false;
+  
+  args.push_back(argv[0]);
+  for (int i = 1; i < argc; ++i)
+  {
+    if (!strcmp(argv[i], "--metrics") && i + 1 < argc)
+    {
+      multi = true;
+      metrics = argv[++i];
+    }
+    else if (!strcmp(argv[i], "--format") && i + 1 < argc)
+    {
+      format = argv[++i];
+    }
+    else
+    {
+      args.push_back(argv[i]);
+    }
+  }
+  
+  // in multi-metric mode <TYPE> is replaced by --metrics
+  const int nrArgs = args.size() + (multi ? 1 : 0);
+  if (nrArgs != 7 && nrArgs != 8)
+  {
+    printUsage(argv[0], std::cerr);
+    return 1;
+  }
+  
+  if (format != "tsv" && format != "json")
+  {
+    std::cerr << "Error: format must be tsv or json" << std::endl;
+    return 1;
+  }
+  
+  StlIntVector types;
+  if (multi)
+  {
+    if (!parseMetrics(metrics, types))
+    {
+      std::cerr << "Error: invalid metric list '" << metrics << "'" << std::endl;
       return 1;
+    }
+  }
+  else
+  {
+    types.push_back(atoi(args[6]));
+  }
+  
+  int idx = -1;
+  if (nrArgs == 8)
+  {
+    idx = atoi(args.back());
+  }
+  
+  double alpha = -1;
+  sscanf(args[3], "%lf", &alpha);
+  if (!(0 <= alpha && alpha <= 0.5))
+  {
+    std::cerr << "Error: alpha must be in [0,0.5]" << std::endl;
+    return 1;
+  }
+  
+  double beta = -1;
+  sscanf(args[4], "%lf", &beta);
+  if (!(0.5 <= beta && beta <= 1))
+  {
+    std::cerr << "Error: beta must be in [0.5,1]" << std::endl;
+    return 1;
   }
   
+  double gamma = -1;
+  sscanf(args[5], "%lf", &gamma);
+  if (!(0 <= gamma && gamma <= 1))
+  {
+    std::cerr << "Error: gamma must be in [0,1]" << std::endl;
+    return 1;
+  }
+  
+  AncestryMatrix A;
+  std::string filename_ancestry_matrix = args[2];
+  
+  if (filename_ancestry_matrix != "-")
+  {
+    std::ifstream in(filename_ancestry_matrix.c_str());
+    if (!in.good())
+    {
+      std::cerr << "Error: failed to open '" << filename_ancestry_matrix << "' for reading" << std::endl;
+      return 1;
+    }
+    in >> A;
+    in.close();
+  }
+  
+  ReadCountMatrix R;
+  std::string read_count_matrix = args[1];
+  
+  if (read_count_matrix != "-")
+  {
+    std::ifstream in(read_count_matrix.c_str());
+    if (!in.good())
+    {
+      std::cerr << "Error: failed to open '" << read_count_matrix << "' for reading" << std::endl;
+      return 1;
+    }
+    in >> R;
+    in.close();
+  }
+  
+  //ProbAncestryGraphYoshiko G(A, R, alpha, gamma);
+  ProbAncestryGraph G(A, R, alpha, gamma);
+  
+  StlIntMatrix toOrginalColumns;
+  G.removeCycles(A, alpha, toOrginalColumns);
+  
+  ReadCountMatrix newR = R.collapse(toOrginalColumns);
+  newR.remapLabels(toOrginalColumns, R);
+  RealIntervalMatrix CI;
+  newR.computeConfidenceIntervals(CI, gamma);
+  
+  ProbAncestryGraph H;
+  G.contract(A, toOrginalColumns, beta, H);
+//  H.writeDOT(newR, CI, std::cout);
+  
+  if (!multi)
+  {
+    return analyse(types.front(), idx, gamma,
+                   R, A, G, toOrginalColumns, newR, CI, H,
+                   std::cout) ? 0 : 1;
+  }
+  
+  // G, H and CI are shared by all requested metrics, the output is only
+  // written once every metric succeeded
+  bool json = format == "json";
+  std::stringstream out;
+  if (json)
+  {
+    out << "{";
+  }
+  
+  bool first = true;
+  for (StlIntVectorIt it = types.begin(); it != types.end(); ++it)
+  {
+    std::stringstream ss;
+    if (!analyse(*it, idx, gamma,
+                 R, A, G, toOrginalColumns, newR, CI, H,
+                 ss))
+    {
+      return 1;
+    }
+    
+    std::string value = ss.str();
+    while (!value.empty() && value[value.size() - 1] == '\n')
+    {
+      value.erase(value.size() - 1);
+    }
+    
+    if (json)
+    {
+      out << (first ? "" : ",") << "\n  \"" << *it << "\": " << jsonValue(value);
+    }
+    else
+    {
+      out << *it << "\t" << escape(value, false) << std::endl;
+    }
+    first = false;
+  }
+  
+  if (json)
+  {
+    out << "\n}" << std::endl;
+  }
+  std::cout << out.str();
+  
   return 0;
-}
\ No newline at end of file
+}
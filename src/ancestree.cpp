@@ -7,13 +7,24 @@
 
 #include <lemon/arg_parser.h>
 #include <fstream>
+#include <thread>
 
 #include "config.h"
 #include "utils.h"
 #include "readcountmatrix.h"
 #include "ancestrymatrix.h"
 #include "probancestrygraph.h"
+#ifdef HAVE_MILP
 #include "intmaxilpsolver.h"
+#include "rootdecomposedsolver.h"
+#include "samplerefinementsolver.h"
+#include "hierarchicalsolver.h"
+#endif
+#include "branchboundsolver.h"
+#include "subsetdpsolver.h"
+#include "heuristicsolver.h"
+#include "presolver.h"
+#include "lagrangianbound.h"
 #include "solutiongraph.h"
 
 using namespace vaff;
@@ -25,11 +36,37 @@ int main(int argc, char** argv)
   double alpha = 0.3;
   double beta = 0.8;
   double gamma = 0.01;
+  double coarseAlpha = -1;
   
   int timeLimit = -1;
+  bool flow = false;
+  bool noPresolve = false;
+  bool coverCuts = false;
+  bool rootDecomposition = false;
+  int nrThreads = std::max(1, (int)std::thread::hardware_concurrency());
+  int dpThreshold = 0;
+  int mipStartTime = 0;
+  int nrSeedSamples = -1;
+  int nrInitialSamples = 0;
+  int nrTrees = 0;
+  int nrLagrangianIterations = 0;
+#ifdef HAVE_MILP
+  std::string solverName = "ilp";
+#else
+  std::string solverName = "bb";
+#endif
+  
+  std::string backendName;
   
   std::string solOutput;
   std::string dotOutput;
+  std::string mpsOutput;
+  std::string warmStartInput;
+  std::string ancestryInput;
+  std::string checkpointFile;
+  std::string incumbentOutput;
+  std::string telemetryOutput;
+  double telemetryInterval = 5;
   
   ap.boolOption("-version", "Show version number")
     .synonym("v", "-version")
@@ -45,6 +82,27 @@ int main(int argc, char** argv)
     .synonym("d", "-dot")
     .refOption("-time", "Time limit (default: -1, disabled)", timeLimit)
     .synonym("t", "-time")
+    .refOption("-flow", "Use the flow formulation of the sum rule", flow)
+    .refOption("-nopresolve", "Disable removal of unusable arcs and root candidates", noPresolve)
+    .refOption("-cover", "Add sum rule cover cuts", coverCuts)
+    .refOption("-lazy", "Add the sum rule rows of all but this many samples lazily (default: -1, disabled)", nrSeedSamples)
+    .refOption("-refine", "Solve the ILP on this many samples first, doubling them until a tree feasible for all samples attains the bound (default: 0, disabled)", nrInitialSamples)
+    .refOption("-coarse", "Solve the ILP on the clustering of this larger alpha first and then on the arcs consistent with the coarse tree, which is not optimal (default: -1, disabled)", coarseAlpha)
+    .refOption("-roots", "Solve one ILP per root candidate in parallel", rootDecomposition)
+    .refOption("-solver", "Solver: 'ilp' (MILP), 'bb' (branch-and-bound) or 'heuristic' (greedy and local search, not optimal) (default: 'ilp' if available)", solverName)
+    .refOption("-backend", "MILP backend: 'cplex' or 'highs' (default: first available)", backendName)
+    .refOption("-mps", "ILP MPS output filename (default: /dev/null)", mpsOutput)
+    .refOption("-telemetry", "ILP telemetry output filename, one JSON object per line (default: /dev/null)", telemetryOutput)
+    .refOption("-telemetry-interval", "Seconds between ILP progress records (default: 5)", telemetryInterval)
+    .refOption("-incumbent", "Output filename that is atomically replaced by every improving ILP incumbent (default: /dev/null)", incumbentOutput)
+    .refOption("-warm-start", "Solution file whose first tree is used as ILP start", warmStartInput)
+    .refOption("-ancestry", "Ancestry matrix of construct_ancestry_matrix for the first mutations and samples of the read counts, only the remaining entries are computed", ancestryInput)
+    .refOption("-threads", "Number of branch-and-bound or root decomposition threads (default: #cores)", nrThreads)
+    .refOption("-dp", "Use the subset DP, which maximizes the tree size only, for graphs with at most this many vertices (default: 0, disabled)", dpThreshold)
+    .refOption("-enumerate", "Enumerate up to this many optimal ILP trees, writing each as a single solution once it is found (default: 0, disabled; -1: no limit)", nrTrees)
+    .refOption("-checkpoint", "File that records the enumerated trees, from which an interrupted enumeration is resumed", checkpointFile)
+    .refOption("-mipstart", "Time budget in seconds of the heuristic ILP start (default: 0, disabled; -1: no perturbation)", mipStartTime)
+    .refOption("-lagrangian", "Subgradient iterations of the Lagrangian tree size bound, which is added to the ILP; if the heuristic start attains it, only the frequencies of that tree are optimized (default: 0, disabled)", nrLagrangianIterations)
     .other("read_count_file", "Read counts");
   ap.parse();
   
@@ -78,6 +136,63 @@ int main(int argc, char** argv)
     return 1;
   }
   
+#ifdef HAVE_MILP
+  if (solverName != "ilp" && solverName != "bb" && solverName != "heuristic")
+#else
+  if (solverName != "bb" && solverName != "heuristic")
+#endif
+  {
+    std::cerr << "Error: unsupported solver '" << solverName << "'" << std::endl;
+    return 1;
+  }
+  
+#ifdef HAVE_MILP
+  if (backendName != "")
+  {
+    MilpBackend::StringVector available = MilpBackend::getAvailable();
+    if (std::find(available.begin(), available.end(), backendName) == available.end())
+    {
+      std::cerr << "Error: unsupported MILP backend '" << backendName << "'" << std::endl;
+      return 1;
+    }
+  }
+#endif
+  
+  if (coarseAlpha != -1 && !(alpha <= coarseAlpha && coarseAlpha <= 0.5))
+  {
+    std::cerr << "Error: value of coarse should be in [alpha,0.5]" << std::endl;
+    return 1;
+  }
+  
+  if (!(0 <= dpThreshold && dpThreshold <= SubsetDpSolver::MAX_NODES))
+  {
+    std::cerr << "Error: value of dp should be in [0," << SubsetDpSolver::MAX_NODES << "]" << std::endl;
+    return 1;
+  }
+  
+  // these options only apply to the plain ILP, the other solvers would
+  // silently ignore them
+  bool ilpOnly = nrTrees != 0 || checkpointFile != "" || warmStartInput != ""
+    || nrSeedSamples >= 0 || incumbentOutput != "" || telemetryOutput != ""
+    || mpsOutput != "" || mipStartTime != 0 || nrLagrangianIterations > 0;
+  if (ilpOnly && (solverName != "ilp" || rootDecomposition || nrInitialSamples > 0 || coarseAlpha != -1 || dpThreshold > 0))
+  {
+    std::cerr << "Error: enumerate, checkpoint, warm-start, lazy, incumbent, telemetry, mps, mipstart and lagrangian require solver 'ilp' without roots, refine, coarse or dp" << std::endl;
+    return 1;
+  }
+  
+  if (nrTrees != 0 && dotOutput != "")
+  {
+    std::cerr << "Error: enumerate does not support dot" << std::endl;
+    return 1;
+  }
+  
+  if (nrTrees == 0 && checkpointFile != "")
+  {
+    std::cerr << "Error: checkpoint requires enumerate" << std::endl;
+    return 1;
+  }
+  
   ReadCountMatrix R;
   std::ifstream in(ap.files()[0].c_str());
   if (!in.good())
@@ -91,9 +206,33 @@ int main(int argc, char** argv)
   std::cerr << "#samples: " << R.getNrCols() << std::endl
             << "#mutations: " << R.getNrRows() << std::endl << std::endl;
   
-  // order hard-coded to 0
-  std::cerr << "Computing ancestry matrix..." << std::endl;
-  AncestryMatrix A(R, 0);
+  // order hard-coded to 0, entries below 0.5 - alpha do not affect the graphs
+  double threshold = 0.5 - std::max(alpha, coarseAlpha);
+  AncestryMatrix A;
+  bool extended = false;
+  if (ancestryInput != "")
+  {
+    std::ifstream ancestryIn(ancestryInput.c_str());
+    if (!ancestryIn.good())
+    {
+      std::cerr << "Error: failed to open '" << ancestryInput << "' for reading" << std::endl;
+      return 1;
+    }
+    std::cerr << "Extending ancestry matrix..." << std::endl;
+    ancestryIn >> A;
+    ancestryIn.close();
+    
+    extended = A.getOrder() == 0 && A.getThreshold() <= threshold && A.extend(R);
+    if (!extended)
+    {
+      std::cerr << "Warning: '" << ancestryInput << "' does not match the read counts" << std::endl;
+    }
+  }
+  if (!extended)
+  {
+    std::cerr << "Computing ancestry matrix..." << std::endl;
+    A = AncestryMatrix(R, 0, threshold);
+  }
   std::cerr << std::endl;
   
   std::cerr << "Computing ancestry graph..." << std::endl;
@@ -115,16 +254,302 @@ int main(int argc, char** argv)
   std::cerr << "|V| = " << lemon::countNodes(H.getG()) << std::endl;
   std::cerr << "|A| = " << lemon::countArcs(H.getG()) << std::endl << std::endl;
   
-  std::cerr << "Constructing ILP..." << std::endl;
-  IntMaxIlpSolver solver(H,
-                         CI,
-                         F,
-                         toOrginalColumns,
-                         timeLimit);
+  Presolver presolver(H, CI);
+  if (!noPresolve)
+  {
+    std::cerr << "Presolving..." << std::endl;
+    presolver.run();
+    presolver.printReport(std::cerr);
+    std::cerr << "|A| = " << lemon::countArcs(H.getG()) << std::endl << std::endl;
+  }
+  
+#ifdef HAVE_MILP
+  // the coarse level of the hierarchical solver
+  StlIntMatrix coarseColumns;
+  RealIntervalMatrix coarseCI;
+  ProbAncestryGraph coarseH;
+#endif
   
-  std::cerr << "Solving ILP..." << std::endl;
   MaxSolution solution(F);
-  solver.solve(solution);
+  bool solved = false;
+  if (nrTrees == 0 && lemon::countNodes(H.getG()) <= dpThreshold)
+  {
+    std::cerr << "Solving using subset DP..." << std::endl;
+    SubsetDpSolver dp(H,
+                      CI,
+                      F,
+                      toOrginalColumns,
+                      timeLimit);
+    if (!noPresolve)
+    {
+      dp.applyPresolve(presolver.getRootCandidates());
+    }
+    solved = dp.solve(solution);
+    if (!solved)
+    {
+      std::cerr << "Subset DP did not finish, falling back to solver '" << solverName << "'" << std::endl;
+    }
+  }
+  
+  Solver* pSolver = NULL;
+  if (!solved && solverName == "bb")
+  {
+    BranchBoundSolver* pBranchBound = new BranchBoundSolver(H,
+                                                            CI,
+                                                            F,
+                                                            toOrginalColumns,
+                                                            timeLimit,
+                                                            nrThreads);
+    if (!noPresolve)
+    {
+      pBranchBound->applyPresolve(presolver.getRootCandidates());
+    }
+    pSolver = pBranchBound;
+  }
+  else if (!solved && solverName == "heuristic")
+  {
+    HeuristicSolver* pHeuristic = new HeuristicSolver(H,
+                                                      CI,
+                                                      F,
+                                                      toOrginalColumns,
+                                                      timeLimit);
+    if (!noPresolve)
+    {
+      pHeuristic->applyPresolve(presolver.getRootCandidates());
+    }
+    pSolver = pHeuristic;
+  }
+#ifdef HAVE_MILP
+  else if (!solved && rootDecomposition)
+  {
+    RootDecomposedSolver* pRootDecomposed = new RootDecomposedSolver(H,
+                                                                     CI,
+                                                                     F,
+                                                                     toOrginalColumns,
+                                                                     timeLimit,
+                                                                     nrThreads,
+                                                                     flow ? IntMaxIlpSolver::FLOW_FORMULATION
+                                                                          : IntMaxIlpSolver::PRODUCT_FORMULATION,
+                                                                     backendName);
+    if (!noPresolve)
+    {
+      pRootDecomposed->applyPresolve(presolver.getRootCandidates(),
+                                     presolver.getNonRootIntervals());
+    }
+    pRootDecomposed->setCoverCuts(coverCuts);
+    pSolver = pRootDecomposed;
+  }
+  else if (!solved && nrInitialSamples > 0)
+  {
+    SampleRefinementSolver* pRefinement = new SampleRefinementSolver(H,
+                                                                     CI,
+                                                                     F,
+                                                                     toOrginalColumns,
+                                                                     timeLimit,
+                                                                     nrInitialSamples,
+                                                                     flow ? IntMaxIlpSolver::FLOW_FORMULATION
+                                                                          : IntMaxIlpSolver::PRODUCT_FORMULATION,
+                                                                     backendName);
+    if (!noPresolve)
+    {
+      pRefinement->applyPresolve(presolver.getRootCandidates(),
+                                 presolver.getNonRootIntervals());
+    }
+    pSolver = pRefinement;
+  }
+  else if (!solved && coarseAlpha != -1)
+  {
+    std::cerr << "Clustering ancestry graph (coarse)..." << std::endl;
+    ProbAncestryGraph coarseG(A, R, coarseAlpha, gamma);
+    coarseG.removeCycles(A, coarseAlpha, coarseColumns);
+    ReadCountMatrix coarseR = R.collapse(coarseColumns);
+    coarseCI = RealIntervalMatrix(coarseR.getNrCols(), coarseR.getNrRows());
+    coarseR.computeConfidenceIntervals(coarseCI, gamma);
+    coarseG.contract(A, coarseColumns, beta, coarseH);
+    
+    std::cerr << "|V| = " << lemon::countNodes(coarseH.getG()) << std::endl;
+    std::cerr << "|A| = " << lemon::countArcs(coarseH.getG()) << std::endl << std::endl;
+    
+    pSolver = new HierarchicalSolver(H,
+                                     CI,
+                                     F,
+                                     toOrginalColumns,
+                                     coarseH,
+                                     coarseCI,
+                                     coarseColumns,
+                                     timeLimit,
+                                     flow ? IntMaxIlpSolver::FLOW_FORMULATION
+                                          : IntMaxIlpSolver::PRODUCT_FORMULATION,
+                                     backendName);
+  }
+  else if (!solved)
+  {
+    std::cerr << "Constructing ILP..." << std::endl;
+    IntMaxIlpSolver* pIlp = new IntMaxIlpSolver(H,
+                                                CI,
+                                                F,
+                                                toOrginalColumns,
+                                                timeLimit,
+                                                flow ? IntMaxIlpSolver::FLOW_FORMULATION
+                                                     : IntMaxIlpSolver::PRODUCT_FORMULATION,
+                                                backendName);
+    if (!noPresolve)
+    {
+      pIlp->applyPresolve(presolver.getRootCandidates(),
+                          presolver.getNonRootIntervals());
+    }
+    if (coverCuts)
+    {
+      std::cerr << "Static cover cuts: " << pIlp->addCoverCuts() << std::endl;
+    }
+    if (nrSeedSamples >= 0)
+    {
+      std::cerr << "Lazy sum rule rows: " << pIlp->setLazySamples(nrSeedSamples) << std::endl;
+    }
+    if (mpsOutput != "" && !pIlp->writeMPS(mpsOutput))
+    {
+      std::cerr << "Error: failed to open '" << mpsOutput << "' for writing" << std::endl;
+      delete pIlp;
+      return 1;
+    }
+    if (incumbentOutput != "")
+    {
+      pIlp->setIncumbentOutput(incumbentOutput);
+    }
+    if (telemetryOutput != "" && !pIlp->setTelemetryOutput(telemetryOutput, telemetryInterval))
+    {
+      std::cerr << "Error: failed to open '" << telemetryOutput << "' for writing" << std::endl;
+      delete pIlp;
+      return 1;
+    }
+    bool started = false;
+    if (warmStartInput != "")
+    {
+      std::ifstream startIn(warmStartInput.c_str());
+      if (!startIn.good())
+      {
+        std::cerr << "Error: failed to open '" << warmStartInput << "' for reading" << std::endl;
+        delete pIlp;
+        return 1;
+      }
+      MaxSolution start;
+      startIn >> start;
+      startIn.close();
+      
+      started = start.size() > 0 && pIlp->setMipStart(start.solution(0));
+      if (!started)
+      {
+        std::cerr << "Warning: tree of '" << warmStartInput << "' is not a feasible start" << std::endl;
+      }
+    }
+    MaxSolution heuristicSolution(F);
+    StlIntVector heuristicParent;
+    int heuristicSize = 0;
+    if (!started && mipStartTime != 0)
+    {
+      std::cerr << "Computing heuristic ILP start..." << std::endl;
+      HeuristicSolver heuristic(H,
+                                CI,
+                                F,
+                                toOrginalColumns,
+                                mipStartTime);
+      if (!noPresolve)
+      {
+        heuristic.applyPresolve(presolver.getRootCandidates());
+      }
+      if (heuristic.solve(heuristicSolution))
+      {
+        heuristicParent = heuristic.getParent();
+        pIlp->setMipStart(heuristicParent);
+        heuristicSize = heuristicParent.size() - std::count(heuristicParent.begin(), heuristicParent.end(), -2);
+      }
+    }
+    if (nrLagrangianIterations > 0)
+    {
+      std::cerr << "Computing Lagrangian bound..." << std::endl;
+      LagrangianBound lagrangian(H,
+                                 CI,
+                                 F,
+                                 toOrginalColumns);
+      if (!noPresolve)
+      {
+        lagrangian.applyPresolve(presolver.getRootCandidates(),
+                                 presolver.getNonRootIntervals());
+      }
+      int sizeBound = lagrangian.run(nrLagrangianIterations, heuristicSize);
+      std::cerr << "Tree size bound: " << sizeBound
+                << ", objective bound: " << lagrangian.getObjBound()
+                << ", iterations: " << lagrangian.getNrIterations() << std::endl;
+      
+      // the start has the maximum number of vertices, the ILP restricted
+      // to its arcs sets its frequencies, but another tree of that size may
+      // have a smaller deviation; enumeration still needs the full ILP
+      if (nrTrees == 0 && heuristicSize >= sizeBound)
+      {
+        std::cerr << "[" << heuristicSize << " vertices, size certified by Lagrangian bound]" << std::endl;
+        delete pIlp;
+        pIlp = NULL;
+        
+        BaseAncestryGraph T;
+        H.restrict(heuristicParent, T);
+        IntMaxIlpSolver treeIlp(T,
+                                CI,
+                                F,
+                                toOrginalColumns,
+                                timeLimit,
+                                flow ? IntMaxIlpSolver::FLOW_FORMULATION
+                                     : IntMaxIlpSolver::PRODUCT_FORMULATION,
+                                backendName);
+        treeIlp.setMipStart(heuristicParent);
+        std::cerr << "Solving frequencies of the certified tree..." << std::endl;
+        solved = treeIlp.solve(solution);
+        if (!solved)
+        {
+          std::cerr << "Warning: using greedy frequencies of the certified tree" << std::endl;
+          solution = heuristicSolution;
+          solved = true;
+        }
+      }
+      else
+      {
+        pIlp->addSizeBound(sizeBound);
+      }
+    }
+    if (pIlp)
+    {
+      std::cerr << "Backend: " << pIlp->getBackendName() << std::endl;
+    }
+    if (nrTrees != 0)
+    {
+      // the trees of a resumed enumeration are appended to the solution output
+      bool resume = checkpointFile != "" && std::ifstream(checkpointFile.c_str()).good();
+      std::ofstream solOut;
+      if (solOutput != "")
+      {
+        solOut.open(solOutput.c_str(), resume ? std::ios::app : std::ios::out);
+      }
+      
+      std::cerr << "Enumerating..." << std::endl;
+      int nrWritten = pIlp->enumerate(nrTrees, checkpointFile, solOutput == "" ? std::cout : solOut);
+      delete pIlp;
+      return nrWritten > 0 ? 0 : 1;
+    }
+    pSolver = pIlp;
+  }
+#endif
+  
+  if (pSolver)
+  {
+    std::cerr << "Solving..." << std::endl;
+    solved = pSolver->solve(solution);
+    delete pSolver;
+  }
+  
+  if (!solved)
+  {
+    std::cerr << "Error: no solution found" << std::endl;
+    return 1;
+  }
   
   if (solOutput == "")
   {
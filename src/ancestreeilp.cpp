@@ -201,7 +201,7 @@ int main(int argc, char** argv)
                          toOrginalColumns,
                          timeLimit);
   
-//  solver.exportModel("model.lp");
+//  solver.writeMPS("model.mps");
   MaxSolution solution(F);
   solver.solve(solution);
   
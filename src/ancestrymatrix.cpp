@@ -7,38 +7,377 @@
 
 #include "ancestrymatrix.h"
 #include <cmath>
+#include <sstream>
+#include <unordered_map>
 
 namespace vaff {
 
 AncestryMatrix::AncestryMatrix()
   : _n(0)
   , _C()
+  , _toProfile()
+  , _representative()
+  , _order(-1)
+  , _threshold(0)
+  , _nrSamples(-1)
+  , _fingerprint()
 {
 }
   
 AncestryMatrix::AncestryMatrix(const ReadCountMatrix& R,
-                               int order)
+                               int order,
+                               double threshold)
   : _n(R.getNrRows())
-  , _C(_n, StlDoubleVector(_n, 0))
+  , _C()
+  , _toProfile()
+  , _representative()
+  , _order(order)
+  , _threshold(threshold)
+  , _nrSamples(R.getNrCols())
+  , _fingerprint(_n)
 {
+  for (int j = 0; j < _n; ++j)
+  {
+    _fingerprint[j] = R.hashRow(j);
+  }
+  
+  // mutations with identical read counts have identical entries
+  ReadCountMatrix uniqueR = R.deduplicate(_toProfile);
+  const int m = uniqueR.getNrCols();
+  const int n = uniqueR.getNrRows();
+  
+  _representative = StlIntVector(n, -1);
+  for (int j = _n - 1; j >= 0; --j)
+  {
+    _representative[_toProfile[j]] = j;
+  }
+  _C = StlDoubleMatrix(n, StlDoubleVector(n, 0));
+  
   StlDoubleVector log_fact;
   
   int max_count = 0;
+  for (int i = 0; i < m; ++i)
+  {
+    for (int j = 0; j < n; ++j)
+    max_count = std::max(max_count, std::max(uniqueR.getAlt(j, i), uniqueR.getRef(j, i)));
+  }
+  
+  constructLogFactorialTable(4*max_count, log_fact);
+  
+  if (threshold > 0)
+  {
+    StlIntMatrix candidates;
+    candidatePairs(uniqueR, order, threshold, candidates);
+    for (int p = 0; p < n; ++p)
+    {
+      for (StlIntVectorIt it = candidates[p].begin(); it != candidates[p].end(); ++it)
+      {
+        _C[p][*it] = prob(uniqueR, order, log_fact, p, *it);
+      }
+    }
+  }
+  else
+  {
+    for (int p = 0; p < n; ++p)
+    {
+      for (int q = 0; q < n; ++q)
+      {
+        _C[p][q] = prob(uniqueR, order, log_fact, p, q);
+      }
+    }
+  }
+}
+  
+bool AncestryMatrix::extend(const ReadCountMatrix& R)
+{
+  typedef std::unordered_multimap<size_t, int> HashIndex;
+  typedef HashIndex::const_iterator HashIndexIt;
+  
   const int m = R.getNrCols();
   const int n = R.getNrRows();
+  if (_fingerprint.size() != _n || m < _nrSamples || n < _n
+      || (m > _nrSamples && _order != 0))
+  {
+    return false;
+  }
+  for (int j = 0; j < _n; ++j)
+  {
+    if (R.hashRow(j, _nrSamples) != _fingerprint[j])
+    {
+      return false;
+    }
+  }
+  
+  if (m > _nrSamples)
+  {
+    addSamples(R);
+  }
+  if (n == _n)
+  {
+    return true;
+  }
+  
+  // maps the hash of every profile to the profile, new mutations with the
+  // read counts of an existing profile are added to it
+  const int old_n = _n;
+  const int old_nrProfiles = _representative.size();
+  HashIndex index;
+  for (int k = 0; k < old_nrProfiles; ++k)
+  {
+    index.insert(std::make_pair(_fingerprint[_representative[k]], k));
+  }
+  
+  const StlIntMatrix& alt = R.getC();
+  const StlIntMatrix& ref = R.getD();
+  for (int j = old_n; j < n; ++j)
+  {
+    size_t h = R.hashRow(j);
+    int profile = -1;
+    std::pair<HashIndexIt, HashIndexIt> range = index.equal_range(h);
+    for (HashIndexIt it = range.first; it != range.second; ++it)
+    {
+      int rep = _representative[it->second];
+      if (alt[rep] == alt[j] && ref[rep] == ref[j])
+      {
+        profile = it->second;
+        break;
+      }
+    }
+    
+    if (profile == -1)
+    {
+      profile = _representative.size();
+      _representative.push_back(j);
+      index.insert(std::make_pair(h, profile));
+    }
+    _toProfile.push_back(profile);
+    _fingerprint.push_back(h);
+  }
+  _n = n;
+  
+  const int nrProfiles = _representative.size();
+  for (int k = 0; k < old_nrProfiles; ++k)
+  {
+    _C[k].resize(nrProfiles, 0);
+  }
+  _C.resize(nrProfiles, StlDoubleVector(nrProfiles, 0));
+  
+  // read counts of the profiles, in which only the pairs with a new profile
+  // are computed
+  StlIntMatrix profiles(nrProfiles);
+  for (int k = 0; k < nrProfiles; ++k)
+  {
+    profiles[k].push_back(_representative[k]);
+  }
+  ReadCountMatrix uniqueR = R.collapse(profiles);
+  
+  StlDoubleVector log_fact;
+  
+  int max_count = 0;
   for (int i = 0; i < m; ++i)
   {
-    for (int j = 0; j < n; ++j)
+    for (int j = 0; j < nrProfiles; ++j)
+    max_count = std::max(max_count, std::max(uniqueR.getAlt(j, i), uniqueR.getRef(j, i)));
+  }
+  
+  constructLogFactorialTable(4*max_count, log_fact);
+  
+  if (_threshold > 0)
+  {
+    StlIntMatrix candidates;
+    candidatePairs(uniqueR, _order, _threshold, candidates);
+    for (int p = 0; p < nrProfiles; ++p)
+    {
+      for (StlIntVectorIt it = candidates[p].begin(); it != candidates[p].end(); ++it)
+      {
+        if (p >= old_nrProfiles || *it >= old_nrProfiles)
+        {
+          _C[p][*it] = prob(uniqueR, _order, log_fact, p, *it);
+        }
+      }
+    }
+  }
+  else
+  {
+    for (int p = 0; p < nrProfiles; ++p)
+    {
+      for (int q = p < old_nrProfiles ? old_nrProfiles : 0; q < nrProfiles; ++q)
+      {
+        _C[p][q] = prob(uniqueR, _order, log_fact, p, q);
+      }
+    }
+  }
+  
+  return true;
+}
+  
+void AncestryMatrix::addSamples(const ReadCountMatrix& R)
+{
+  typedef std::unordered_multimap<size_t, int> HashIndex;
+  typedef HashIndex::const_iterator HashIndexIt;
+  
+  const int m = R.getNrCols();
+  const StlIntMatrix& alt = R.getC();
+  const StlIntMatrix& ref = R.getD();
+  
+  // profiles of the existing mutations in all samples
+  HashIndex index;
+  StlIntVector toProfile(_n, -1);
+  StlIntVector representative;
+  for (int j = 0; j < _n; ++j)
+  {
+    size_t h = R.hashRow(j);
+    std::pair<HashIndexIt, HashIndexIt> range = index.equal_range(h);
+    for (HashIndexIt it = range.first; it != range.second; ++it)
+    {
+      int rep = representative[it->second];
+      if (alt[rep] == alt[j] && ref[rep] == ref[j])
+      {
+        toProfile[j] = it->second;
+        break;
+      }
+    }
+    
+    if (toProfile[j] == -1)
+    {
+      toProfile[j] = representative.size();
+      representative.push_back(j);
+      index.insert(std::make_pair(h, toProfile[j]));
+    }
+    _fingerprint[j] = h;
+  }
+  
+  StlDoubleVector log_fact;
+  
+  int max_count = 0;
+  for (int i = _nrSamples; i < m; ++i)
+  {
+    for (int j = 0; j < _n; ++j)
     max_count = std::max(max_count, std::max(R.getAlt(j, i), R.getRef(j, i)));
   }
   
   constructLogFactorialTable(4*max_count, log_fact);
   
-  for (int p = 0; p < n; ++p)
+  const int nrProfiles = representative.size();
+  StlDoubleMatrix C(nrProfiles, StlDoubleVector(nrProfiles, 0));
+  for (int k = 0; k < nrProfiles; ++k)
+  {
+    int p = representative[k];
+    for (int l = 0; l < nrProfiles; ++l)
+    {
+      int q = representative[l];
+      double min_p_q = _C[_toProfile[p]][_toProfile[q]];
+      for (int i = _nrSamples; i < m && min_p_q > 0; ++i)
+      {
+        min_p_q = std::min(min_p_q, std::max(0.0, std::min(1.0, prob(R, log_fact, i, p, q))));
+      }
+      C[k][l] = min_p_q;
+    }
+  }
+  
+  _C.swap(C);
+  _toProfile.swap(toProfile);
+  _representative.swap(representative);
+  _nrSamples = m;
+}
+  
+void AncestryMatrix::setIdentityProfiles()
+{
+  _toProfile = StlIntVector(_n);
+  for (int j = 0; j < _n; ++j)
+  {
+    _toProfile[j] = j;
+  }
+  _representative = _toProfile;
+}
+
+void AncestryMatrix::candidatePairs(const ReadCountMatrix& R,
+                                    int order,
+                                    double threshold,
+                                    StlIntMatrix& candidates)
+{
+  typedef std::pair<double, int> DoubleIntPair;
+  typedef std::vector<DoubleIntPair> DoubleIntPairVector;
+  typedef std::pair<int, int> IntPair;
+  typedef std::vector<IntPair> IntPairVector;
+  
+  const int m = R.getNrCols();
+  const int n = R.getNrRows();
+  
+  candidates = StlIntMatrix(n);
+  if (m <= order)
+  {
+    for (int p = 0; p < n; ++p)
+    {
+      for (int q = 0; q < n; ++q)
+      {
+        candidates[p].push_back(q);
+      }
+    }
+    return;
+  }
+  
+  // the tails of the intervals have mass threshold / 2 each, so
+  // P(X_q <= X_p) <= P(X_p > UB_p) + P(X_q < LB_q) = threshold if UB_p < LB_q
+  RealIntervalMatrix CI;
+  R.computeConfidenceIntervals(CI, threshold);
+  
+  // sorted[i] : lower bounds of sample i in increasing order
+  std::vector<DoubleIntPairVector> sorted(m, DoubleIntPairVector(n));
+  for (int i = 0; i < m; ++i)
   {
     for (int q = 0; q < n; ++q)
     {
-      _C[p][q] = prob(R, order, log_fact, p, q);
+      sorted[i][q] = DoubleIntPair(CI(i, q).first, q);
+    }
+    std::sort(sorted[i].begin(), sorted[i].end());
+  }
+  
+  IntPairVector prefix(m);
+  StlBoolVector visited(n, false);
+  StlIntVector scanned;
+  for (int p = 0; p < n; ++p)
+  {
+    // prefix[i] : number of q with LB_q <= UB_p in sample i
+    for (int i = 0; i < m; ++i)
+    {
+      DoubleIntPair key(CI(i, p).second, n);
+      prefix[i] = IntPair(std::upper_bound(sorted[i].begin(), sorted[i].end(), key) - sorted[i].begin(), i);
+    }
+    std::partial_sort(prefix.begin(), prefix.begin() + order + 1, prefix.end());
+    
+    // a candidate is not separated from p in one of the order + 1 samples
+    scanned.clear();
+    for (int idx = 0; idx <= order; ++idx)
+    {
+      const DoubleIntPairVector& S = sorted[prefix[idx].second];
+      for (int l = 0; l < prefix[idx].first; ++l)
+      {
+        int q = S[l].second;
+        if (visited[q])
+        {
+          continue;
+        }
+        visited[q] = true;
+        scanned.push_back(q);
+        
+        int nrSeparated = 0;
+        for (int i = 0; i < m && nrSeparated <= order; ++i)
+        {
+          if (CI(i, p).second < CI(i, q).first)
+          {
+            ++nrSeparated;
+          }
+        }
+        if (nrSeparated <= order)
+        {
+          candidates[p].push_back(q);
+        }
+      }
+    }
+    for (StlIntVectorIt it = scanned.begin(); it != scanned.end(); ++it)
+    {
+      visited[*it] = false;
     }
   }
 }
@@ -167,7 +506,28 @@ double AncestryMatrix::log_beta(const StlDoubleVector& log_fact,
 std::ostream& operator<<(std::ostream& out,
                          const AncestryMatrix& matrix)
 {
-  out << matrix._C;
+  // the rows and columns of duplicate profiles are written out in full
+  const int n = matrix._n;
+  out << n << std::endl;
+  out << (n == 0 ? -1 : n) << std::endl;
+  for (int p = 0; p < n; ++p)
+  {
+    for (int q = 0; q < n; ++q)
+    {
+      out << matrix(p, q) << " ";
+    }
+    out << std::endl;
+  }
+  
+  if (matrix._fingerprint.size() == n)
+  {
+    out << matrix._order << " " << matrix._threshold << " " << matrix._nrSamples << std::endl;
+    for (int j = 0; j < n; ++j)
+    {
+      out << matrix._fingerprint[j] << " ";
+    }
+    out << std::endl;
+  }
   return out;
 }
 
@@ -176,6 +536,36 @@ std::istream& operator>>(std::istream& in,
 {
   in >> matrix._C;
   matrix._n = matrix._C.size();
+  matrix.setIdentityProfiles();
+  
+  // matrices without fingerprint cannot be extended
+  matrix._order = -1;
+  matrix._threshold = 0;
+  matrix._nrSamples = -1;
+  matrix._fingerprint.clear();
+  
+  std::string line;
+  if (vaff::getline(in, line) && !line.empty())
+  {
+    std::stringstream ss(line);
+    ss >> matrix._order >> matrix._threshold >> matrix._nrSamples;
+    
+    vaff::getline(in, line);
+    ss.clear();
+    ss.str(line);
+    size_t h;
+    while (ss >> h)
+    {
+      matrix._fingerprint.push_back(h);
+    }
+    
+    if (matrix._fingerprint.size() != matrix._n)
+    {
+      matrix._order = -1;
+      matrix._fingerprint.clear();
+    }
+  }
+  
   return in;
 }
   
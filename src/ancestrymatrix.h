@@ -20,17 +20,57 @@ class AncestryMatrix
 public:
   AncestryMatrix();
   
+  // only the entries that can be at least threshold are computed, the
+  // others are 0; a threshold of 0 computes all entries. Mutations with
+  // identical read counts share their rows and columns, which are computed
+  // once per distinct profile
   AncestryMatrix(const ReadCountMatrix& R,
-                 int order);
+                 int order,
+                 double threshold = 0);
   
   double operator()(int row, int col) const
   {
     assert(0 <= row && row < _n);
     assert(0 <= col && col < _n);
     
-    return _C[row][col];
+    return _C[_toProfile[row]][_toProfile[col]];
   }
   
+  // first mutation with the same read counts as mutation row
+  int getRepresentative(int row) const
+  {
+    assert(0 <= row && row < _n);
+    
+    return _representative[_toProfile[row]];
+  }
+  
+  // number of distinct read count profiles
+  int getNrProfiles() const
+  {
+    return _representative.size();
+  }
+  
+  // order the matrix was computed with, -1 if it was read without fingerprint
+  int getOrder() const
+  {
+    return _order;
+  }
+  
+  // threshold the matrix was computed with
+  double getThreshold() const
+  {
+    return _threshold;
+  }
+  
+  // computes the rows and columns of the mutations appended to R since the
+  // matrix was computed, with the same order and threshold. Samples
+  // appended to R are only supported for order 0, where every entry is
+  // lowered to the minimum with the new samples; entries that are 0 stay 0.
+  // Returns false and leaves the matrix unchanged if it has no fingerprint,
+  // or if the read counts of the existing mutations in the existing samples
+  // differ from the fingerprint
+  bool extend(const ReadCountMatrix& R);
+  
   int getNrRows() const
   {
     return _n;
@@ -71,7 +111,7 @@ public:
         {
           continue;
         }
-//        if (!tol.nonZero(1 - (_C[i][j] + _C[j][i])))
+//        if (!tol.nonZero(1 - ((*this)(i, j) + (*this)(j, i))))
         {
           out << R.getRowLabel(i);
           for (int k = 0; k < m; ++k)
@@ -120,7 +160,7 @@ public:
             std::cout << "+";
           }
           
-          if (!tol.nonZero(1 - (_C[i][j] + _C[j][i])))
+          if (!tol.nonZero(1 - ((*this)(i, j) + (*this)(j, i))))
           {
             std::cout << "*";
           }
@@ -146,7 +186,7 @@ public:
     {
       for (int j = i + 1; j < _n; ++j)
       {
-//        if (!tol.nonZero(1 - (_C[i][j] + _C[j][i])))
+//        if (!tol.nonZero(1 - ((*this)(i, j) + (*this)(j, i))))
         {
           out << R.getRowLabel(i);
           for (int k = 0; k < m; ++k)
@@ -217,7 +257,7 @@ public:
         if (j == k)
           continue;
         
-        if (!tol.nonZero(1 - (_C[j][k] + _C[k][j])))
+        if (!tol.nonZero(1 - ((*this)(j, k) + (*this)(k, j))))
         {
           ++res;
         }
@@ -235,7 +275,7 @@ public:
     {
       for (int j = i + 1; j < _n; ++j)
       {
-        if (!tol.nonZero(1 - (_C[i][j] + _C[j][i])))
+        if (!tol.nonZero(1 - ((*this)(i, j) + (*this)(j, i))))
         {
           ++res;
         }
@@ -247,6 +287,19 @@ public:
   static void constructLogFactorialTable(const int n,
                                          StlDoubleVector& log_fact);
   
+  // candidates[p] : mutations q for which prob(R, order, log_fact, p, q)
+  // can be at least threshold; if the (1 - threshold) posterior interval of
+  // p lies below the one of q in a sample, the probability that p is an
+  // ancestor of q in that sample is less than threshold, so q is a
+  // candidate if this happens in at most order samples. Per sample, the
+  // mutations sorted by lower bound give the q that are not separated from
+  // p as a prefix, only the union of the order + 1 shortest prefixes is
+  // scanned
+  static void candidatePairs(const ReadCountMatrix& R,
+                             int order,
+                             double threshold,
+                             StlIntMatrix& candidates);
+  
   static double prob(const ReadCountMatrix& R,
                      int order,
                      const StlDoubleVector& log_fact,
@@ -273,7 +326,26 @@ public:
 
 private:
   int _n;
+  // _C[k][l] : entry of the k-th and l-th distinct profile
   StlDoubleMatrix _C;
+  // _toProfile[j] : profile of mutation j
+  StlIntVector _toProfile;
+  // _representative[k] : first mutation with profile k
+  StlIntVector _representative;
+  // fingerprint of the read counts the matrix was computed from, written
+  // after the matrix: order, threshold, number of samples and the hash of
+  // every row of R
+  int _order;
+  double _threshold;
+  int _nrSamples;
+  std::vector<size_t> _fingerprint;
+  
+  void setIdentityProfiles();
+  
+  // takes the minimum of the existing entries with the probabilities in the
+  // samples appended to R, the profiles of the existing mutations are split
+  // by their read counts in these samples
+  void addSamples(const ReadCountMatrix& R);
 };
   
 } // namespace vaff
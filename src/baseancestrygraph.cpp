@@ -99,4 +99,59 @@ void BaseAncestryGraph::contract(const StlIntMatrix& toOrginalColumns,
 //  }
 }
   
+void BaseAncestryGraph::induce(const StlIntVector& columns,
+                               BaseAncestryGraph& H) const
+{
+  H._G.clear();
+  
+  int n = columns.size();
+  H._G.reserveNode(n);
+  H._columnToNode = NodeVector(n, lemon::INVALID);
+  
+  IntNodeMap toNewColumn(_G, -1);
+  for (int k = 0; k < n; ++k)
+  {
+    Node v_k = H._G.addNode();
+    H._nodeToColumn[v_k] = k;
+    H._columnToNode[k] = v_k;
+    toNewColumn[_columnToNode[columns[k]]] = k;
+  }
+  
+  for (ArcIt a(_G); a != lemon::INVALID; ++a)
+  {
+    int index_u = toNewColumn[_G.source(a)];
+    int index_v = toNewColumn[_G.target(a)];
+    if (index_u != -1 && index_v != -1)
+    {
+      Arc b = H._G.addArc(H._columnToNode[index_u], H._columnToNode[index_v]);
+      H._prob[b] = _prob[a];
+    }
+  }
+}
+  
+void BaseAncestryGraph::restrict(const StlIntVector& parent,
+                                 BaseAncestryGraph& T) const
+{
+  T._G.clear();
+  T._columnToNode = NodeVector(_columnToNode.size(), lemon::INVALID);
+  
+  for (NodeIt v(_G); v != lemon::INVALID; ++v)
+  {
+    Node w = T._G.addNode();
+    T._nodeToColumn[w] = _nodeToColumn[v];
+    T._columnToNode[_nodeToColumn[v]] = w;
+  }
+  
+  for (ArcIt a(_G); a != lemon::INVALID; ++a)
+  {
+    int j = _nodeToColumn[_G.source(a)];
+    int k = _nodeToColumn[_G.target(a)];
+    if (parent[k] == j)
+    {
+      Arc b = T._G.addArc(T._columnToNode[j], T._columnToNode[k]);
+      T._prob[b] = _prob[a];
+    }
+  }
+}
+  
 } // namespace vaff
\ No newline at end of file
@@ -195,6 +195,20 @@ public:
   void contract(const StlIntMatrix& toOrginalColumns,
                 BaseAncestryGraph& H) const;
   
+  // subgraph induced by columns, column k of H is column columns[k]
+  void induce(const StlIntVector& columns,
+              BaseAncestryGraph& H) const;
+  
+  // spanning subgraph with only the arcs of the tree given by parent, as in
+  // Solver::computeFrequencies
+  void restrict(const StlIntVector& parent,
+                BaseAncestryGraph& T) const;
+  
+  void removeArc(Arc a)
+  {
+    _G.erase(a);
+  }
+  
   const DoubleArcMap& getProbMap() const
   {
     return _prob;
@@ -0,0 +1,174 @@
+/*
+ *  benchmarkhierarchical.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "utils.h"
+#include "readcountmatrix.h"
+#include "ancestrymatrix.h"
+#include "probancestrygraph.h"
+#include "presolver.h"
+#include "intmaxilpsolver.h"
+#include "hierarchicalsolver.h"
+#include <lemon/time_measure.h>
+#include <fstream>
+
+using namespace vaff;
+
+void printUsage(const char* argv0, std::ostream& out)
+{
+  out << "Usage: " << argv0 << " <ALPHA> <COARSE_ALPHA> <BETA> <GAMMA> <TIMELIMIT> <READ_COUNTS> ... where" << std::endl
+      << "  <ALPHA>            alpha parameter (clustering)" << std::endl
+      << "  <COARSE_ALPHA>     alpha parameter of the coarse clustering" << std::endl
+      << "  <BETA>             beta parameter (ancestry)" << std::endl
+      << "  <GAMMA>            gamma parameter (CI)" << std::endl
+      << "  <TIMELIMIT>        time limit in seconds of each solve (use -1 to disable time limit)" << std::endl
+      << "  <READ_COUNTS>      read count files, e.g. ../data/simulated/*/*.input" << std::endl;
+  out << "Output (tab separated, one line per file):\n"
+         "  file\n"
+         "  #vertices\n"
+         "  #arcs\n"
+         "  #coarse vertices\n"
+         "  #arcs consistent with the coarse tree\n"
+         "  monolithic objective value\n"
+         "  monolithic best bound\n"
+         "  monolithic solve time (s)\n"
+         "  hierarchical objective value\n"
+         "  hierarchical solve time (s)\n"
+         "  gap of the hierarchical objective value to the monolithic bound (%)" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 7)
+  {
+    printUsage(argv[0], std::cerr);
+    return 1;
+  }
+  
+  double alpha = -1;
+  sscanf(argv[1], "%lf", &alpha);
+  if (!(0 <= alpha && alpha <= 0.5))
+  {
+    std::cerr << "Error: alpha must be in [0,0.5]" << std::endl;
+    return 1;
+  }
+  
+  double coarseAlpha = -1;
+  sscanf(argv[2], "%lf", &coarseAlpha);
+  if (!(alpha <= coarseAlpha && coarseAlpha <= 0.5))
+  {
+    std::cerr << "Error: coarse alpha must be in [alpha,0.5]" << std::endl;
+    return 1;
+  }
+  
+  double beta = -1;
+  sscanf(argv[3], "%lf", &beta);
+  if (!(0.5 <= beta && beta <= 1))
+  {
+    std::cerr << "Error: beta must be in [0.5,1]" << std::endl;
+    return 1;
+  }
+  
+  double gamma = -1;
+  sscanf(argv[4], "%lf", &gamma);
+  if (!(0 <= gamma && gamma <= 1))
+  {
+    std::cerr << "Error: gamma must be in [0,1]" << std::endl;
+    return 1;
+  }
+  
+  int timeLimit = atoi(argv[5]);
+  
+  for (int f = 6; f < argc; ++f)
+  {
+    ReadCountMatrix R;
+    std::ifstream in(argv[f]);
+    if (!in.good())
+    {
+      std::cerr << "Error: failed to open '" << argv[f] << "' for reading" << std::endl;
+      return 1;
+    }
+    in >> R;
+    in.close();
+    
+    AncestryMatrix A(R, 0, 0.5 - coarseAlpha);
+    RealMatrix F;
+    R.computePointEstimates(F);
+    
+    ProbAncestryGraph G(A, R, alpha, gamma);
+    StlIntMatrix toOrginalColumns;
+    G.removeCycles(A, alpha, toOrginalColumns);
+    ReadCountMatrix newR = R.collapse(toOrginalColumns);
+    RealIntervalMatrix CI(newR.getNrCols(), newR.getNrRows());
+    newR.computeConfidenceIntervals(CI, gamma);
+    ProbAncestryGraph H;
+    G.contract(A, toOrginalColumns, beta, H);
+    
+    ProbAncestryGraph coarseG(A, R, coarseAlpha, gamma);
+    StlIntMatrix coarseColumns;
+    coarseG.removeCycles(A, coarseAlpha, coarseColumns);
+    ReadCountMatrix coarseR = R.collapse(coarseColumns);
+    RealIntervalMatrix coarseCI(coarseR.getNrCols(), coarseR.getNrRows());
+    coarseR.computeConfidenceIntervals(coarseCI, gamma);
+    ProbAncestryGraph coarseH;
+    coarseG.contract(A, coarseColumns, beta, coarseH);
+    
+    Presolver presolver(H, CI);
+    presolver.run();
+    
+    std::cout << argv[f] << "\t"
+              << lemon::countNodes(H.getG()) << "\t"
+              << lemon::countArcs(H.getG()) << "\t"
+              << lemon::countNodes(coarseH.getG()) << "\t";
+    
+    lemon::Timer timer;
+    IntMaxIlpSolver monolithic(H, CI, F, toOrginalColumns, timeLimit);
+    monolithic.applyPresolve(presolver.getRootCandidates(),
+                             presolver.getNonRootIntervals());
+    MaxSolution monolithicSolution(F);
+    bool monolithicSolved = monolithic.solve(monolithicSolution);
+    double monolithicTime = timer.realTime();
+    
+    timer.restart();
+    HierarchicalSolver hierarchical(H, CI, F, toOrginalColumns,
+                                    coarseH, coarseCI, coarseColumns, timeLimit);
+    MaxSolution hierarchicalSolution(F);
+    bool hierarchicalSolved = hierarchical.solve(hierarchicalSolution);
+    double hierarchicalTime = timer.realTime();
+    
+    std::cout << (hierarchicalSolved ? hierarchical.getNrRestrictedArcs() : 0) << "\t";
+    if (monolithicSolved)
+    {
+      std::cout << monolithic.getObjValue() << "\t" << monolithic.getBestObjValue();
+    }
+    else
+    {
+      std::cout << "-\t-";
+    }
+    std::cout << "\t" << monolithicTime << "\t";
+    if (hierarchicalSolved)
+    {
+      std::cout << hierarchical.getObjValue();
+    }
+    else
+    {
+      std::cout << "-";
+    }
+    std::cout << "\t" << hierarchicalTime << "\t";
+    if (monolithicSolved && hierarchicalSolved)
+    {
+      double bound = monolithic.getBestObjValue();
+      std::cout << 100 * (bound - hierarchical.getObjValue()) / bound;
+    }
+    else
+    {
+      std::cout << "-";
+    }
+    std::cout << std::endl;
+  }
+  
+  return 0;
+}
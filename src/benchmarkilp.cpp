@@ -0,0 +1,143 @@
+/*
+ *  benchmarkilp.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "utils.h"
+#include "readcountmatrix.h"
+#include "ancestrymatrix.h"
+#include "probancestrygraph.h"
+#include "intmaxilpsolver.h"
+#include <lemon/time_measure.h>
+#include <fstream>
+
+using namespace vaff;
+
+void printUsage(const char* argv0, std::ostream& out)
+{
+  out << "Usage: " << argv0 << " <ALPHA> <BETA> <GAMMA> <TIMELIMIT> <READ_COUNTS> ... where" << std::endl
+      << "  <ALPHA>            alpha parameter (clustering)" << std::endl
+      << "  <BETA>             beta parameter (ancestry)" << std::endl
+      << "  <GAMMA>            gamma parameter (CI)" << std::endl
+      << "  <TIMELIMIT>        time limit in seconds (use -1 to disable time limit)" << std::endl
+      << "  <READ_COUNTS>      read count files, e.g. ../data/real/*.txt ../data/simulated/*/*.input" << std::endl;
+  out << "Output (tab separated, one line per file, formulation and MILP backend):\n"
+         "  file\n"
+         "  formulation\n"
+         "  backend\n"
+         "  #variables\n"
+         "  #constraints\n"
+         "  #non-zeros\n"
+         "  LP relaxation bound\n"
+         "  objective value\n"
+         "  best bound\n"
+         "  solve time (s)" << std::endl;
+}
+
+void benchmark(const std::string& filename,
+               const ProbAncestryGraph& H,
+               const RealIntervalMatrix& CI,
+               const RealMatrix& F,
+               const StlIntMatrix& toOrginalColumns,
+               int timeLimit,
+               IntMaxIlpSolver::Formulation formulation,
+               const std::string& backend,
+               std::ostream& out)
+{
+  IntMaxIlpSolver solver(H, CI, F, toOrginalColumns, timeLimit, formulation, backend);
+  
+  out << filename << "\t"
+      << (formulation == IntMaxIlpSolver::FLOW_FORMULATION ? "flow" : "product") << "\t"
+      << backend << "\t"
+      << solver.getNrVariables() << "\t"
+      << solver.getNrConstraints() << "\t"
+      << solver.getNrNonZeros() << "\t"
+      << solver.solveRelaxation() << "\t";
+  
+  lemon::Timer timer;
+  MaxSolution solution(F);
+  if (solver.solve(solution))
+  {
+    out << solver.getObjValue() << "\t" << solver.getBestObjValue();
+  }
+  else
+  {
+    out << "-\t-";
+  }
+  out << "\t" << timer.realTime() << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 6)
+  {
+    printUsage(argv[0], std::cerr);
+    return 1;
+  }
+  
+  double alpha = -1;
+  sscanf(argv[1], "%lf", &alpha);
+  if (!(0 <= alpha && alpha <= 0.5))
+  {
+    std::cerr << "Error: alpha must be in [0,0.5]" << std::endl;
+    return 1;
+  }
+  
+  double beta = -1;
+  sscanf(argv[2], "%lf", &beta);
+  if (!(0.5 <= beta && beta <= 1))
+  {
+    std::cerr << "Error: beta must be in [0.5,1]" << std::endl;
+    return 1;
+  }
+  
+  double gamma = -1;
+  sscanf(argv[3], "%lf", &gamma);
+  if (!(0 <= gamma && gamma <= 1))
+  {
+    std::cerr << "Error: gamma must be in [0,1]" << std::endl;
+    return 1;
+  }
+  
+  int timeLimit = atoi(argv[4]);
+  
+  MilpBackend::StringVector backends = MilpBackend::getAvailable();
+  
+  for (int f = 5; f < argc; ++f)
+  {
+    ReadCountMatrix R;
+    std::ifstream in(argv[f]);
+    if (!in.good())
+    {
+      std::cerr << "Error: failed to open '" << argv[f] << "' for reading" << std::endl;
+      return 1;
+    }
+    in >> R;
+    in.close();
+    
+    AncestryMatrix A(R, 0, 0.5 - alpha);
+    ProbAncestryGraph G(A, R, alpha, gamma);
+    
+    StlIntMatrix toOrginalColumns;
+    G.removeCycles(A, alpha, toOrginalColumns);
+    RealMatrix F;
+    R.computePointEstimates(F);
+    ReadCountMatrix newR = R.collapse(toOrginalColumns);
+    RealIntervalMatrix CI(newR.getNrCols(), newR.getNrRows());
+    newR.computeConfidenceIntervals(CI, gamma);
+    ProbAncestryGraph H;
+    G.contract(A, toOrginalColumns, beta, H);
+    
+    for (MilpBackend::StringVector::const_iterator it = backends.begin(); it != backends.end(); ++it)
+    {
+      benchmark(argv[f], H, CI, F, toOrginalColumns, timeLimit,
+                IntMaxIlpSolver::PRODUCT_FORMULATION, *it, std::cout);
+      benchmark(argv[f], H, CI, F, toOrginalColumns, timeLimit,
+                IntMaxIlpSolver::FLOW_FORMULATION, *it, std::cout);
+    }
+  }
+  
+  return 0;
+}
@@ -0,0 +1,577 @@
+/*
+ *  branchboundsolver.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "branchboundsolver.h"
+#include <thread>
+
+namespace vaff {
+
+class BranchBoundSolver::Worker
+{
+public:
+  Worker(BranchBoundSolver& solver, int id);
+  
+  void run();
+  
+  long getNrBranchNodes() const
+  {
+    return _nrBranchNodes;
+  }
+
+private:
+  // previous values of _childSum[j][i] and _need[j][i]
+  struct LogEntry
+  {
+    LogEntry(int j, int i, double childSum, double need)
+      : _j(j)
+      , _i(i)
+      , _childSum(childSum)
+      , _need(need)
+    {
+    }
+    
+    int _j;
+    int _i;
+    double _childSum;
+    double _need;
+  };
+  
+  typedef std::vector<LogEntry> LogEntryVector;
+  
+  struct Level
+  {
+    Level(int arc, int logSize)
+      : _arc(arc)
+      , _include(true)
+      , _donated(false)
+      , _logSize(logSize)
+    {
+    }
+    
+    int _arc;
+    // current branch, the exclude branch is explored second
+    bool _include;
+    // the exclude branch has been handed to another worker
+    bool _donated;
+    int _logSize;
+  };
+  
+  typedef std::vector<Level> LevelVector;
+  
+  BranchBoundSolver& _solver;
+  const int _id;
+  const int _m;
+  
+  Task _task;
+  // _parent[j] : column of the parent of v_j, -1 for the root, -2 if absent
+  StlIntVector _parent;
+  StlIntVector _nodes;
+  StlBoolVector _excluded;
+  // _need[j][i] : smallest f[i][j] that accommodates the subtree of v_j
+  StlDoubleMatrix _need;
+  StlDoubleMatrix _childSum;
+  LogEntryVector _log;
+  LevelVector _trail;
+  
+  StlBoolVector _reached;
+  StlIntVector _queue;
+  long _nrBranchNodes;
+  
+  // returns false if the root or a replayed decision is infeasible
+  bool reset();
+  
+  bool include(int a);
+  
+  void undo(int logSize, int v);
+  
+  bool fits(int j, int k) const;
+  
+  int select() const;
+  
+  int bound();
+  
+  bool visit();
+  
+  bool backtrack();
+  
+  void donate();
+};
+
+BranchBoundSolver::Worker::Worker(BranchBoundSolver& solver, int id)
+  : _solver(solver)
+  , _id(id)
+  , _m(solver._F_interval_clustered.getNrRows())
+  , _task()
+  , _parent(solver._outArcs.size(), -2)
+  , _nodes()
+  , _excluded(solver._arcSource.size(), false)
+  , _need(solver._outArcs.size(), StlDoubleVector(_m, 0))
+  , _childSum(solver._outArcs.size(), StlDoubleVector(_m, 0))
+  , _log()
+  , _trail()
+  , _reached(solver._outArcs.size(), false)
+  , _queue()
+  , _nrBranchNodes(0)
+{
+}
+
+void BranchBoundSolver::Worker::run()
+{
+  while (_solver.getTask(_id, _task))
+  {
+    if (!reset())
+    {
+      continue;
+    }
+    while (!_solver._stop)
+    {
+      if (!visit() && !backtrack())
+      {
+        break;
+      }
+    }
+  }
+}
+
+bool BranchBoundSolver::Worker::reset()
+{
+  std::fill(_parent.begin(), _parent.end(), -2);
+  std::fill(_excluded.begin(), _excluded.end(), false);
+  _nodes.clear();
+  _trail.clear();
+  
+  const int r = _task._root;
+  for (int i = 0; i < _m; ++i)
+  {
+    if (g_tol.less(_solver._ub[r][i], _solver._lb[r][i]))
+    {
+      return false;
+    }
+  }
+  
+  _parent[r] = -1;
+  _nodes.push_back(r);
+  _need[r] = _solver._lb[r];
+  std::fill(_childSum[r].begin(), _childSum[r].end(), 0);
+  
+  for (DecisionVector::const_iterator it = _task._decisions.begin();
+       it != _task._decisions.end(); ++it)
+  {
+    if (!it->_include)
+    {
+      _excluded[it->_arc] = true;
+    }
+    else if (!include(it->_arc))
+    {
+      return false;
+    }
+  }
+  
+  // replayed decisions are never undone
+  _log.clear();
+  return true;
+}
+
+bool BranchBoundSolver::Worker::include(int a)
+{
+  const int u = _solver._arcSource[a];
+  const int v = _solver._arcTarget[a];
+  const int logSize = _log.size();
+  
+  // a cluster whose CI lower bound exceeds 0.5 cannot be a tree vertex
+  for (int i = 0; i < _m; ++i)
+  {
+    if (g_tol.less(_solver._ub[v][i], _solver._lb[v][i]))
+    {
+      return false;
+    }
+  }
+  
+  _parent[v] = u;
+  _nodes.push_back(v);
+  
+  // propagate the increase of need[v] towards the root
+  bool feasible = true;
+  for (int i = 0; i < _m && feasible; ++i)
+  {
+    _need[v][i] = _solver._lb[v][i];
+    _childSum[v][i] = 0;
+    
+    double delta = _need[v][i];
+    for (int w = u; feasible && w >= 0 && delta > 0; w = _parent[w])
+    {
+      _log.push_back(LogEntry(w, i, _childSum[w][i], _need[w][i]));
+      _childSum[w][i] += delta;
+      double need = std::max(_solver._lb[w][i], _childSum[w][i]);
+      delta = need - _need[w][i];
+      _need[w][i] = need;
+      feasible = !g_tol.less(_solver._ub[w][i], need);
+    }
+  }
+  
+  if (!feasible)
+  {
+    undo(logSize, v);
+  }
+  
+  return feasible;
+}
+
+void BranchBoundSolver::Worker::undo(int logSize, int v)
+{
+  while ((int)_log.size() > logSize)
+  {
+    const LogEntry& entry = _log.back();
+    _childSum[entry._j][entry._i] = entry._childSum;
+    _need[entry._j][entry._i] = entry._need;
+    _log.pop_back();
+  }
+  
+  _parent[v] = -2;
+  _nodes.pop_back();
+}
+
+bool BranchBoundSolver::Worker::fits(int j, int k) const
+{
+  // need only grows along a branch, so the remaining capacity of a tree
+  // node is an upper bound for the rest of the subtree
+  for (int i = 0; i < _m; ++i)
+  {
+    if (g_tol.less(_solver._ub[j][i] - _childSum[j][i], _solver._lb[k][i]))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+int BranchBoundSolver::Worker::select() const
+{
+  int res = -1;
+  for (StlIntVectorIt it = _nodes.begin(); it != _nodes.end(); ++it)
+  {
+    const StlIntVector& arcs = _solver._outArcs[*it];
+    for (StlIntVectorIt it2 = arcs.begin(); it2 != arcs.end(); ++it2)
+    {
+      int a = *it2;
+      if (!_excluded[a] && _parent[_solver._arcTarget[a]] == -2 && (res == -1 || a < res))
+      {
+        res = a;
+      }
+    }
+  }
+  return res;
+}
+
+int BranchBoundSolver::Worker::bound()
+{
+  // number of vertices that can still be reached from the tree
+  _queue = _nodes;
+  for (StlIntVectorIt it = _nodes.begin(); it != _nodes.end(); ++it)
+  {
+    _reached[*it] = true;
+  }
+  
+  int res = 0;
+  for (size_t idx = 0; idx < _queue.size(); ++idx)
+  {
+    const int u = _queue[idx];
+    const StlIntVector& arcs = _solver._outArcs[u];
+    for (StlIntVectorIt it = arcs.begin(); it != arcs.end(); ++it)
+    {
+      const int v = _solver._arcTarget[*it];
+      if (_excluded[*it] || _reached[v] || (_parent[u] != -2 && !fits(u, v)))
+      {
+        continue;
+      }
+      _reached[v] = true;
+      _queue.push_back(v);
+      ++res;
+    }
+  }
+  
+  for (StlIntVectorIt it = _queue.begin(); it != _queue.end(); ++it)
+  {
+    _reached[*it] = false;
+  }
+  
+  return res;
+}
+
+bool BranchBoundSolver::Worker::visit()
+{
+  if ((++_nrBranchNodes & 1023) == 0)
+  {
+    _solver.checkTimeLimit();
+  }
+  
+  if (_solver._nrIdle > _solver._nrQueued)
+  {
+    donate();
+  }
+  
+  const int size = _nodes.size();
+  if (size > _solver._bestSize)
+  {
+    _solver.updateIncumbent(_parent, size);
+  }
+  
+  if (size + bound() <= _solver._bestSize)
+  {
+    return false;
+  }
+  
+  const int a = select();
+  if (a == -1)
+  {
+    return false;
+  }
+  
+  _trail.push_back(Level(a, _log.size()));
+  if (!include(a))
+  {
+    _trail.back()._include = false;
+    _excluded[a] = true;
+  }
+  
+  return true;
+}
+
+bool BranchBoundSolver::Worker::backtrack()
+{
+  while (!_trail.empty())
+  {
+    Level& level = _trail.back();
+    if (level._include)
+    {
+      undo(level._logSize, _solver._arcTarget[level._arc]);
+      if (!level._donated)
+      {
+        level._include = false;
+        _excluded[level._arc] = true;
+        return true;
+      }
+    }
+    else
+    {
+      _excluded[level._arc] = false;
+    }
+    _trail.pop_back();
+  }
+  
+  return false;
+}
+
+void BranchBoundSolver::Worker::donate()
+{
+  // hand out the shallowest open exclude branch, it has the largest subtree
+  for (size_t k = 0; k < _trail.size(); ++k)
+  {
+    Level& level = _trail[k];
+    if (level._include && !level._donated)
+    {
+      Task task;
+      task._root = _task._root;
+      task._decisions = _task._decisions;
+      for (size_t l = 0; l < k; ++l)
+      {
+        task._decisions.push_back(Decision(_trail[l]._arc, _trail[l]._include));
+      }
+      task._decisions.push_back(Decision(level._arc, false));
+      
+      level._donated = true;
+      _solver.pushTask(_id, task);
+      return;
+    }
+  }
+}
+
+BranchBoundSolver::BranchBoundSolver(const BaseAncestryGraph& G,
+                                     const RealIntervalMatrix& F_interval_clustered,
+                                     const RealMatrix& F_point_unclustered,
+                                     const StlIntMatrix& toUnclusteredColumn,
+                                     int timeLimit,
+                                     int nrThreads)
+  : Solver(G, F_interval_clustered, F_point_unclustered, toUnclusteredColumn, timeLimit)
+  , _nrThreads(std::max(1, nrThreads))
+  , _arcSource()
+  , _arcTarget()
+  , _outArcs(F_interval_clustered.getNrCols())
+  , _rootCandidate(F_interval_clustered.getNrCols(), true)
+  , _lb(F_interval_clustered.getNrCols())
+  , _ub(F_interval_clustered.getNrCols())
+  , _mutex()
+  , _cv()
+  , _tasks()
+  , _nrIdle(0)
+  , _nrQueued(0)
+  , _stop(false)
+  , _bestSize(0)
+  , _bestParent()
+  , _timer()
+  , _nrBranchNodes(0)
+  , _optimal(false)
+  , _objValue(0)
+{
+  const Digraph& g = _G.getG();
+  const int m = _F_interval_clustered.getNrRows();
+  const int n = _F_interval_clustered.getNrCols();
+  
+  for (ArcIt a(g); a != lemon::INVALID; ++a)
+  {
+    int j = _G.mapNodeToColumn(g.source(a));
+    _outArcs[j].push_back(_arcSource.size());
+    _arcSource.push_back(j);
+    _arcTarget.push_back(_G.mapNodeToColumn(g.target(a)));
+  }
+  
+  for (int j = 0; j < n; ++j)
+  {
+    _lb[j] = StlDoubleVector(m, 0);
+    _ub[j] = StlDoubleVector(m, 0);
+    for (int i = 0; i < m; ++i)
+    {
+      _lb[j][i] = _F_interval_clustered(i, j).first;
+      _ub[j][i] = std::min(0.5, _F_interval_clustered(i, j).second);
+    }
+  }
+}
+
+bool BranchBoundSolver::getTask(int id, Task& task)
+{
+  std::unique_lock<std::mutex> lock(_mutex);
+  
+  ++_nrIdle;
+  while (!_stop)
+  {
+    TaskDeque& own = _tasks[id];
+    if (!own.empty())
+    {
+      task = own.back();
+      own.pop_back();
+      --_nrQueued;
+      --_nrIdle;
+      return true;
+    }
+    
+    for (int t = 1; t < _nrThreads; ++t)
+    {
+      TaskDeque& other = _tasks[(id + t) % _nrThreads];
+      if (!other.empty())
+      {
+        task = other.front();
+        other.pop_front();
+        --_nrQueued;
+        --_nrIdle;
+        return true;
+      }
+    }
+    
+    if (_nrIdle == _nrThreads)
+    {
+      break;
+    }
+    _cv.wait(lock);
+  }
+  
+  _cv.notify_all();
+  return false;
+}
+
+void BranchBoundSolver::pushTask(int id, const Task& task)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  _tasks[id].push_back(task);
+  ++_nrQueued;
+  _cv.notify_one();
+}
+
+void BranchBoundSolver::updateIncumbent(const StlIntVector& parent, int size)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (size > _bestSize)
+  {
+    _bestSize = size;
+    _bestParent = parent;
+  }
+}
+
+void BranchBoundSolver::checkTimeLimit()
+{
+  if (_timeLimit > 0 && _timer.realTime() > _timeLimit)
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stop = true;
+    _cv.notify_all();
+  }
+}
+
+void BranchBoundSolver::runWorker(int id)
+{
+  Worker worker(*this, id);
+  worker.run();
+  _nrBranchNodes += worker.getNrBranchNodes();
+}
+
+bool BranchBoundSolver::solve(MaxSolution& solution)
+{
+  const int n = _F_interval_clustered.getNrCols();
+  
+  _tasks = TaskDequeVector(_nrThreads);
+  _nrQueued = 0;
+  for (int j = 0; j < n; ++j)
+  {
+    if (_rootCandidate[j])
+    {
+      Task task;
+      task._root = j;
+      _tasks[_nrQueued % _nrThreads].push_back(task);
+      ++_nrQueued;
+    }
+  }
+  
+  _nrIdle = 0;
+  _stop = false;
+  _bestSize = 0;
+  _nrBranchNodes = 0;
+  _timer.restart();
+  
+  std::vector<std::thread> threads;
+  for (int id = 0; id < _nrThreads; ++id)
+  {
+    threads.push_back(std::thread(&BranchBoundSolver::runWorker, this, id));
+  }
+  for (int id = 0; id < _nrThreads; ++id)
+  {
+    threads[id].join();
+  }
+  
+  _optimal = !_stop;
+  if (_bestSize == 0)
+  {
+    return false;
+  }
+  
+  StlDoubleMatrix f;
+  if (!computeFrequencies(_bestParent, f))
+  {
+    return false;
+  }
+  
+  MaxSolution::Triple sol;
+  constructSolution(_bestParent, f, sol);
+  solution.clear();
+  solution.add(sol);
+  
+  _objValue = _bestSize - deviation(f);
+  std::cerr << "[" << _objValue << ", " << (_optimal ? "optimal" : "time limit")
+            << ", " << _nrBranchNodes << " nodes]" << std::endl;
+  
+  return true;
+}
+
+} // namespace vaff
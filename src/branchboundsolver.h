@@ -0,0 +1,125 @@
+/*
+ *  branchboundsolver.h
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#ifndef BRANCHBOUNDSOLVER_H
+#define BRANCHBOUNDSOLVER_H
+
+#include "solver.h"
+#include <lemon/time_measure.h>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+namespace vaff {
+
+// combinatorial branch-and-bound on the arcs of G, maximizing the number of
+// tree vertices; trees are grown from a root by including or excluding one
+// arc leaving the current tree at a time
+class BranchBoundSolver : public Solver
+{
+public:
+  BranchBoundSolver(const BaseAncestryGraph& G,
+                    const RealIntervalMatrix& F_interval_clustered,
+                    const RealMatrix& F_point_unclustered,
+                    const StlIntMatrix& toUnclusteredColumn,
+                    int timeLimit,
+                    int nrThreads);
+  
+  bool solve(MaxSolution& solution);
+  
+  void applyPresolve(const StlBoolVector& rootCandidate)
+  {
+    _rootCandidate = rootCandidate;
+  }
+  
+  // false if the time limit was hit
+  bool isOptimal() const
+  {
+    return _optimal;
+  }
+  
+  double getObjValue() const
+  {
+    return _objValue;
+  }
+  
+  long getNrBranchNodes() const
+  {
+    return _nrBranchNodes;
+  }
+
+private:
+  class Worker;
+  friend class Worker;
+  
+  struct Decision
+  {
+    Decision(int arc, bool include)
+      : _arc(arc)
+      , _include(include)
+    {
+    }
+    
+    int _arc;
+    bool _include;
+  };
+  
+  typedef std::vector<Decision> DecisionVector;
+  
+  // subproblem: the tree rooted at _root obtained by replaying _decisions
+  struct Task
+  {
+    int _root;
+    DecisionVector _decisions;
+  };
+  
+  typedef std::deque<Task> TaskDeque;
+  typedef std::vector<TaskDeque> TaskDequeVector;
+  
+  const int _nrThreads;
+  
+  // arcs of G by index, _outArcs[j] lists the arcs leaving v_j
+  StlIntVector _arcSource;
+  StlIntVector _arcTarget;
+  StlIntMatrix _outArcs;
+  StlBoolVector _rootCandidate;
+  // _lb[j][i] and _ub[j][i] : bounds on f[i][j]
+  StlDoubleMatrix _lb;
+  StlDoubleMatrix _ub;
+  
+  // per worker deques, workers pop their own tasks from the back and
+  // steal from the front of the others
+  std::mutex _mutex;
+  std::condition_variable _cv;
+  TaskDequeVector _tasks;
+  std::atomic<int> _nrIdle;
+  std::atomic<int> _nrQueued;
+  std::atomic<bool> _stop;
+  
+  std::atomic<int> _bestSize;
+  StlIntVector _bestParent;
+  
+  lemon::Timer _timer;
+  std::atomic<long> _nrBranchNodes;
+  bool _optimal;
+  double _objValue;
+  
+  bool getTask(int id, Task& task);
+  
+  void pushTask(int id, const Task& task);
+  
+  void updateIncumbent(const StlIntVector& parent, int size);
+  
+  void checkTimeLimit();
+  
+  void runWorker(int id);
+};
+
+} // namespace vaff
+
+#endif // BRANCHBOUNDSOLVER_H
@@ -10,6 +10,7 @@
 #include "readcountmatrix.h"
 //#include "probancestrygraphyoshiko.h"
 #include "probancestrygraph.h"
+#include "vafclustering.h"
 #include <cmath>
 
 #include <fstream>
@@ -18,16 +19,21 @@ using namespace vaff;
 
 void printUsage(const char* argv0, std::ostream& out)
 {
-  out << "Usage: " << argv0 << " <READ_COUNTS> <ALPHA> <BETA> <GAMMA> where" << std::endl
+  out << "Usage: " << argv0 << " <READ_COUNTS> <ALPHA> <BETA> <GAMMA> [<ENGINE>] where" << std::endl
       << "  <READ_COUNTS>      is the ancestry matrix file" << std::endl
       << "  <ALPHA>            alpha parameter (ancestry)" << std::endl
       << "  <BETA>             beta parameter (equality)" << std::endl
-      << "  <GAMMA>            gamma parameter (CI)" << std::endl;
+      << "  <GAMMA>            gamma parameter (CI)" << std::endl
+      << "  <ENGINE>           'graph' (default) clusters the ancestry graph, 'box' merges" << std::endl
+      << "                     mutations with overlapping confidence intervals in all samples" << std::endl
+      << "                     and 'box-verify' splits these clusters into the components" << std::endl
+      << "                     'graph' finds within them; this approximates 'graph', which" << std::endl
+      << "                     may also join mutations of different clusters" << std::endl;
 }
 
 int main(int argc, char** argv)
 {
-  if (argc != 5)
+  if (argc != 5 && argc != 6)
   {
     printUsage(argv[0], std::cerr);
     return 1;
@@ -56,6 +62,13 @@ int main(int argc, char** argv)
     std::cerr << "Error: gamma must be in [0,1]" << std::endl;
     return 1;
   }
+  
+  std::string engine = argc == 6 ? argv[5] : "graph";
+  if (engine != "graph" && engine != "box" && engine != "box-verify")
+  {
+    std::cerr << "Error: engine must be 'graph', 'box' or 'box-verify'" << std::endl;
+    return 1;
+  }
 
   ReadCountMatrix R;
   std::string read_count_matrix = argv[1];
@@ -76,20 +89,33 @@ int main(int argc, char** argv)
     std::cin >> R;
   }
   
-  AncestryMatrix A(R, 0);
-  
-  ProbAncestryGraph G(A, R, alpha, gamma);
-  
   StlIntMatrix toOrginalColumns;
-  G.removeCycles(A, alpha, toOrginalColumns);
+  if (engine == "graph")
+  {
+    AncestryMatrix A(R, 0, 0.5 - alpha);
+    
+    ProbAncestryGraph G(A, R, alpha, gamma);
+    
+    G.removeCycles(A, alpha, toOrginalColumns);
+    
+    ProbAncestryGraph H;
+    G.contract(A, toOrginalColumns, beta, H);
+  }
+  else
+  {
+    // no ancestry matrix, probabilities are only computed within clusters
+    VafClustering clustering(R, gamma);
+    clustering.run(toOrginalColumns);
+    if (engine == "box-verify")
+    {
+      clustering.verify(alpha, toOrginalColumns);
+    }
+  }
 
   ReadCountMatrix newR = R.collapse(toOrginalColumns);
   newR.remapLabels(toOrginalColumns, R);
   RealIntervalMatrix CI;
   newR.computeConfidenceIntervals(CI, gamma);
-  
-  ProbAncestryGraph H;
-  G.contract(A, toOrginalColumns, beta, H);
 
   std::cout << CI;
   std::cout << newR;
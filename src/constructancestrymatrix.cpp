@@ -15,14 +15,17 @@ using namespace vaff;
 
 void printUsage(const char* argv0, std::ostream& out)
 {
-  out << "Usage: " << argv0 << " <READ_COUNT_MATRIX> <ORDER> where" << std::endl
+  out << "Usage: " << argv0 << " <READ_COUNT_MATRIX> <ORDER> [<ANCESTRY_MATRIX>] where" << std::endl
       << "  <READ_COUNT_MATRIX>  is the input file containing read counts\n"
-      << "  <ORDER>              0 for minimum" << std::endl;
+      << "  <ORDER>              0 for minimum\n"
+      << "  <ANCESTRY_MATRIX>    is a previous output of this program for the first\n"
+      << "                       mutations and samples of <READ_COUNT_MATRIX>, only the\n"
+      << "                       appended mutations and samples (order 0) are computed" << std::endl;
 }
 
 int main(int argc, char** argv)
 {
-  if (argc != 3)
+  if (argc != 3 && argc != 4)
   {
     printUsage(argv[0], std::cerr);
     return 1;
@@ -54,6 +57,26 @@ int main(int argc, char** argv)
     return 1;
   }
   
+  if (argc == 4)
+  {
+    AncestryMatrix M;
+    std::ifstream in(argv[3]);
+    if (!in.good())
+    {
+      std::cerr << "Error: failed to open '" << argv[3] << "' for reading" << std::endl;
+      return 1;
+    }
+    in >> M;
+    in.close();
+    
+    if (M.getOrder() == order && M.extend(R))
+    {
+      std::cout << M;
+      return 0;
+    }
+    std::cerr << "Warning: '" << argv[3] << "' does not match the read counts, recomputing all entries" << std::endl;
+  }
+  
   AncestryMatrix M(R, order);
   std::cout << M;
   
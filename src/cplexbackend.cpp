@@ -0,0 +1,345 @@
+/*
+ *  cplexbackend.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "cplexbackend.h"
+
+namespace vaff {
+
+// runs a MilpCutSeparator once the cut loop of a node has finished
+class SeparatorCallback : public IloCplex::UserCutCallbackI
+{
+public:
+  SeparatorCallback(IloEnv env,
+                    const IloNumVarArray& vars,
+                    const MilpCutSeparator* pSeparator)
+    : IloCplex::UserCutCallbackI(env)
+    , _vars(vars)
+    , _pSeparator(pSeparator)
+  {
+  }
+  
+  IloCplex::CallbackI* duplicateCallback() const
+  {
+    return new (getEnv()) SeparatorCallback(*this);
+  }
+  
+  void main();
+
+private:
+  IloNumVarArray _vars;
+  const MilpCutSeparator* _pSeparator;
+};
+
+void SeparatorCallback::main()
+{
+  if (!isAfterCutLoop())
+  {
+    return;
+  }
+  
+  IloEnv env = getEnv();
+  IloNumArray value(env);
+  getValues(value, _vars);
+  
+  const int n = _vars.getSize();
+  StlDoubleVector values(n);
+  for (int k = 0; k < n; ++k)
+  {
+    values[k] = value[k];
+  }
+  value.end();
+  
+  MilpRowVector rows;
+  StlDoubleVector ub;
+  _pSeparator->separate(values, rows, ub);
+  
+  for (size_t r = 0; r < rows.size(); ++r)
+  {
+    const StlIntVector& index = rows[r].getIndices();
+    const StlDoubleVector& coef = rows[r].getValues();
+    
+    IloExpr sum(env);
+    for (int k = 0; k < rows[r].size(); ++k)
+    {
+      sum += coef[k] * _vars[index[k]];
+    }
+    add(sum <= ub[r], IloCplex::UseCutPurge).end();
+    sum.end();
+  }
+}
+
+// reports progress to a MilpProgressListener and the incumbent to a
+// MilpIncumbentListener whenever it changes; CPLEX uses at most one info
+// callback, hence both are served by the same one
+class InfoCallback : public IloCplex::MIPInfoCallbackI
+{
+public:
+  InfoCallback(IloEnv env,
+               const IloNumVarArray& vars,
+               MilpIncumbentListener* pIncumbentListener,
+               MilpProgressListener* pProgressListener)
+    : IloCplex::MIPInfoCallbackI(env)
+    , _vars(vars)
+    , _pIncumbentListener(pIncumbentListener)
+    , _pProgressListener(pProgressListener)
+    , _reported(false)
+    , _objValue(0)
+  {
+  }
+  
+  IloCplex::CallbackI* duplicateCallback() const
+  {
+    return new (getEnv()) InfoCallback(*this);
+  }
+  
+  void main();
+
+private:
+  IloNumVarArray _vars;
+  MilpIncumbentListener* _pIncumbentListener;
+  MilpProgressListener* _pProgressListener;
+  bool _reported;
+  double _objValue;
+};
+
+void InfoCallback::main()
+{
+  if (_pProgressListener)
+  {
+    _pProgressListener->progress(getNnodes64(),
+                                 hasIncumbent(),
+                                 hasIncumbent() ? getIncumbentObjValue() : 0,
+                                 getBestObjValue());
+  }
+  
+  if (!_pIncumbentListener || !hasIncumbent()
+      || (_reported && getIncumbentObjValue() == _objValue))
+  {
+    return;
+  }
+  
+  _reported = true;
+  _objValue = getIncumbentObjValue();
+  
+  IloEnv env = getEnv();
+  IloNumArray value(env);
+  getIncumbentValues(value, _vars);
+  
+  const int n = _vars.getSize();
+  StlDoubleVector values(n);
+  for (int k = 0; k < n; ++k)
+  {
+    values[k] = value[k];
+  }
+  value.end();
+  
+  _pIncumbentListener->improved(values, _objValue, getBestObjValue());
+}
+
+CplexBackend::CplexBackend()
+  : _env()
+  , _model(_env)
+  , _cplex(_model)
+  , _vars(_env)
+  , _intVars(_env)
+  , _values(_env)
+  , _pIncumbentListener(NULL)
+  , _pProgressListener(NULL)
+{
+  _cplex.setOut(std::cerr);
+  _cplex.setWarning(std::cerr);
+  _cplex.setError(std::cerr);
+}
+
+CplexBackend::~CplexBackend()
+{
+  _env.end();
+}
+
+void CplexBackend::load(const MilpModel& model)
+{
+  const int nrCols = model.getNrCols();
+  const int nrRows = model.getNrRows();
+  
+  // CPLEX uses IloInfinity rather than IEEE infinity
+  const double inf = MilpModel::infinity();
+  
+  IloExpr obj(_env);
+  for (int j = 0; j < nrCols; ++j)
+  {
+    double lb = model.getColLB(j) == -inf ? -IloInfinity : model.getColLB(j);
+    double ub = model.getColUB(j) == inf ? IloInfinity : model.getColUB(j);
+    
+    if (model.getColType(j) == MilpModel::BINARY)
+    {
+      IloBoolVar x(_env, model.getColName(j).c_str());
+      x.setLB(lb);
+      x.setUB(ub);
+      _vars.add(x);
+      _intVars.add(x);
+    }
+    else
+    {
+      _vars.add(IloNumVar(_env, lb, ub, ILOFLOAT, model.getColName(j).c_str()));
+    }
+    
+    if (model.getColObj(j) != 0)
+    {
+      obj += model.getColObj(j) * _vars[j];
+    }
+  }
+  
+  // lazy rows are checked by CPLEX whenever it finds an incumbent
+  IloRangeArray rows(_env);
+  IloRangeArray lazyRows(_env);
+  IloExpr sum(_env);
+  for (int r = 0; r < nrRows; ++r)
+  {
+    for (int k = model.getRowStart(r); k < model.getRowStart(r + 1); ++k)
+    {
+      sum += model.getRowValue(k) * _vars[model.getRowIndex(k)];
+    }
+    
+    double lb = model.getRowLB(r) == -inf ? -IloInfinity : model.getRowLB(r);
+    double ub = model.getRowUB(r) == inf ? IloInfinity : model.getRowUB(r);
+    if (model.isRowLazy(r))
+    {
+      lazyRows.add(IloRange(_env, lb, sum, ub));
+    }
+    else
+    {
+      rows.add(IloRange(_env, lb, sum, ub));
+    }
+    sum.clear();
+  }
+  sum.end();
+  
+  _model.add(rows);
+  if (lazyRows.getSize() > 0)
+  {
+    _cplex.addLazyConstraints(lazyRows);
+  }
+  _model.add(IloObjective(_env, obj, model.isMaximize() ? IloObjective::Maximize
+                                                        : IloObjective::Minimize));
+  obj.end();
+}
+
+void CplexBackend::setCutSeparator(const MilpCutSeparator* pSeparator)
+{
+  if (pSeparator)
+  {
+    _cplex.use(IloCplex::Callback(new (_env) SeparatorCallback(_env, _vars, pSeparator)));
+  }
+}
+
+void CplexBackend::setIncumbentListener(MilpIncumbentListener* pListener)
+{
+  _pIncumbentListener = pListener;
+  useInfoCallback();
+}
+
+void CplexBackend::setProgressListener(MilpProgressListener* pListener)
+{
+  _pProgressListener = pListener;
+  useInfoCallback();
+}
+
+void CplexBackend::useInfoCallback()
+{
+  // replaces the info callback in use, if any
+  if (_pIncumbentListener || _pProgressListener)
+  {
+    _cplex.use(IloCplex::Callback(new (_env) InfoCallback(_env,
+                                                          _vars,
+                                                          _pIncumbentListener,
+                                                          _pProgressListener)));
+  }
+}
+
+void CplexBackend::setMipStart(const StlDoubleVector& values)
+{
+  const int n = _vars.getSize();
+  assert(static_cast<int>(values.size()) == n);
+  
+  IloNumArray value(_env, n);
+  for (int k = 0; k < n; ++k)
+  {
+    value[k] = values[k];
+  }
+  _cplex.addMIPStart(_vars, value, IloCplex::MIPStartCheckFeas);
+  value.end();
+}
+
+void CplexBackend::setColBounds(int col, double lb, double ub)
+{
+  const double inf = MilpModel::infinity();
+  _vars[col].setBounds(lb == -inf ? -IloInfinity : lb,
+                       ub == inf ? IloInfinity : ub);
+}
+
+void CplexBackend::addRow(const MilpRow& row, double lb, double ub)
+{
+  const double inf = MilpModel::infinity();
+  const StlIntVector& index = row.getIndices();
+  const StlDoubleVector& value = row.getValues();
+  
+  IloExpr sum(_env);
+  for (int k = 0; k < row.size(); ++k)
+  {
+    sum += value[k] * _vars[index[k]];
+  }
+  _model.add(IloRange(_env,
+                      lb == -inf ? -IloInfinity : lb,
+                      sum,
+                      ub == inf ? IloInfinity : ub));
+  sum.end();
+}
+
+bool CplexBackend::solve(int timeLimit)
+{
+  _cplex.setParam(IloCplex::SolnPoolAGap, 0.0);
+  _cplex.setParam(IloCplex::SolnPoolIntensity, 4);
+  _cplex.setParam(IloCplex::PopulateLim, 20000);
+  
+  if (timeLimit > 0)
+  {
+    _cplex.setParam(IloCplex::TiLim, timeLimit);
+  }
+  
+  return _cplex.solve();
+}
+
+double CplexBackend::solveRelaxation()
+{
+  IloConversion relaxation(_env, _intVars, ILOFLOAT);
+  _model.add(relaxation);
+  
+  double bound = -1;
+  if (_cplex.solve())
+  {
+    bound = _cplex.getObjValue();
+  }
+  
+  _model.remove(relaxation);
+  relaxation.end();
+  
+  return bound;
+}
+
+void CplexBackend::getValues(int solIdx, StlDoubleVector& values) const
+{
+  const int n = _vars.getSize();
+  _cplex.getValues(_values, _vars, solIdx);
+  
+  values.resize(n);
+  for (int k = 0; k < n; ++k)
+  {
+    values[k] = _values[k];
+  }
+}
+
+} // namespace vaff
@@ -0,0 +1,99 @@
+/*
+ *  cplexbackend.h
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#ifndef CPLEXBACKEND_H
+#define CPLEXBACKEND_H
+
+#include "milpbackend.h"
+#include <ilcplex/ilocplex.h>
+
+namespace vaff {
+
+class CplexBackend : public MilpBackend
+{
+public:
+  CplexBackend();
+  
+  ~CplexBackend();
+  
+  std::string getName() const
+  {
+    return "cplex";
+  }
+  
+  void load(const MilpModel& model);
+  
+  bool supportsLazyRows() const
+  {
+    return true;
+  }
+  
+  bool supportsCutSeparator() const
+  {
+    return true;
+  }
+  
+  void setCutSeparator(const MilpCutSeparator* pSeparator);
+  
+  void setIncumbentListener(MilpIncumbentListener* pListener);
+  
+  void setProgressListener(MilpProgressListener* pListener);
+  
+  void setNrThreads(int nrThreads)
+  {
+    _cplex.setParam(IloCplex::Threads, nrThreads);
+  }
+  
+  void setMipStart(const StlDoubleVector& values);
+  
+  void setColBounds(int col, double lb, double ub);
+  
+  void addRow(const MilpRow& row, double lb, double ub);
+  
+  bool solve(int timeLimit);
+  
+  double solveRelaxation();
+  
+  double getObjValue() const
+  {
+    return _cplex.getObjValue();
+  }
+  
+  int getNrSolutions() const
+  {
+    return _cplex.getSolnPoolNsolns();
+  }
+  
+  double getObjValue(int solIdx) const
+  {
+    return _cplex.getObjValue(solIdx);
+  }
+  
+  double getBestObjValue() const
+  {
+    return _cplex.getBestObjValue();
+  }
+  
+  void getValues(int solIdx, StlDoubleVector& values) const;
+
+private:
+  IloEnv _env;
+  IloModel _model;
+  IloCplex _cplex;
+  IloNumVarArray _vars;
+  IloIntVarArray _intVars;
+  // reused by getValues, which is called for every solution in the pool
+  mutable IloNumArray _values;
+  MilpIncumbentListener* _pIncumbentListener;
+  MilpProgressListener* _pProgressListener;
+  
+  void useInfoCallback();
+};
+
+} // namespace vaff
+
+#endif // CPLEXBACKEND_H
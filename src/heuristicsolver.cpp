@@ -0,0 +1,425 @@
+/*
+ *  heuristicsolver.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "heuristicsolver.h"
+
+namespace vaff {
+
+HeuristicSolver::HeuristicSolver(const BaseAncestryGraph& G,
+                                 const RealIntervalMatrix& F_interval_clustered,
+                                 const RealMatrix& F_point_unclustered,
+                                 const StlIntMatrix& toUnclusteredColumn,
+                                 int timeLimit)
+  : Solver(G, F_interval_clustered, F_point_unclustered, toUnclusteredColumn, timeLimit)
+  , _n(F_interval_clustered.getNrCols())
+  , _m(F_interval_clustered.getNrRows())
+  , _order()
+  , _inArcs(_n)
+  , _rootCandidate(_n, true)
+  , _lb(_n)
+  , _ub(_n)
+  , _parent()
+  , _children()
+  , _need()
+  , _childSum()
+  , _size(0)
+  , _bestParent()
+  , _bestSize(0)
+  , _nrImprovements(0)
+  , _timer()
+  , _rng()
+  , _objValue(0)
+{
+  assert(_G.isDAG());
+  
+  const Digraph& g = _G.getG();
+  
+  topologicalOrder(_order);
+  for (int j = 0; j < _n; ++j)
+  {
+    _lb[j] = StlDoubleVector(_m, 0);
+    _ub[j] = StlDoubleVector(_m, 0);
+    for (int i = 0; i < _m; ++i)
+    {
+      _lb[j][i] = _F_interval_clustered(i, j).first;
+      _ub[j][i] = std::min(0.5, _F_interval_clustered(i, j).second);
+    }
+  }
+  
+  // infeasible vertices get no in-neighbors, so they are never inserted
+  for (ArcIt a(g); a != lemon::INVALID; ++a)
+  {
+    int k = _G.mapNodeToColumn(g.target(a));
+    if (feasible(k))
+    {
+      _inArcs[k].push_back(_G.mapNodeToColumn(g.source(a)));
+    }
+  }
+}
+
+void HeuristicSolver::init(int root)
+{
+  _parent = StlIntVector(_n, -2);
+  _children = StlIntMatrix(_n);
+  _need = _lb;
+  _childSum = StlDoubleMatrix(_n, StlDoubleVector(_m, 0));
+  
+  _parent[root] = -1;
+  _size = 1;
+}
+
+bool HeuristicSolver::propagate(int j, const StlDoubleVector& delta, bool apply)
+{
+  for (int i = 0; i < _m; ++i)
+  {
+    double d = delta[i];
+    for (int c = j; c >= 0; c = _parent[c])
+    {
+      double childSum = _childSum[c][i] + d;
+      double need = std::max(_lb[c][i], childSum);
+      if (!apply && g_tol.less(_ub[c][i], need))
+      {
+        return false;
+      }
+      
+      d = need - _need[c][i];
+      if (apply)
+      {
+        _childSum[c][i] = childSum;
+        _need[c][i] = need;
+      }
+      
+      if (d == 0)
+      {
+        break;
+      }
+    }
+  }
+  
+  return true;
+}
+
+bool HeuristicSolver::attach(int v, int u)
+{
+  assert(_parent[u] != -2);
+  
+  if (!propagate(u, _need[v], false))
+  {
+    return false;
+  }
+  
+  propagate(u, _need[v], true);
+  if (_parent[v] == -2)
+  {
+    ++_size;
+  }
+  _parent[v] = u;
+  _children[u].push_back(v);
+  
+  return true;
+}
+
+void HeuristicSolver::detach(int v)
+{
+  int u = _parent[v];
+  assert(u >= 0);
+  
+  StlDoubleVector delta(_need[v]);
+  for (int i = 0; i < _m; ++i)
+  {
+    delta[i] = -delta[i];
+  }
+  propagate(u, delta, true);
+  
+  StlIntVector& C = _children[u];
+  C.erase(std::find(C.begin(), C.end(), v));
+  _parent[v] = -2;
+  --_size;
+}
+
+bool HeuristicSolver::insert(int v, bool randomize)
+{
+  assert(_parent[v] == -2 && _children[v].empty());
+  
+  // a vertex outside the tree is a leaf
+  _need[v] = _lb[v];
+  _childSum[v] = StlDoubleVector(_m, 0);
+  
+  int best = -1;
+  double bestCapacity = -1;
+  for (StlIntVectorIt it = _inArcs[v].begin(); it != _inArcs[v].end(); ++it)
+  {
+    int u = *it;
+    if (_parent[u] == -2 || !propagate(u, _need[v], false))
+    {
+      continue;
+    }
+    
+    if (randomize)
+    {
+      double capacity = std::uniform_real_distribution<double>(0, 1)(_rng);
+      if (capacity > bestCapacity)
+      {
+        best = u;
+        bestCapacity = capacity;
+      }
+      continue;
+    }
+    
+    double capacity = 1;
+    for (int i = 0; i < _m; ++i)
+    {
+      capacity = std::min(capacity, _ub[u][i] - _childSum[u][i] - _need[v][i]);
+    }
+    if (capacity > bestCapacity)
+    {
+      best = u;
+      bestCapacity = capacity;
+    }
+  }
+  
+  return best != -1 && attach(v, best);
+}
+
+int HeuristicSolver::insertAll(bool randomize)
+{
+  int res = 0;
+  for (StlIntVectorIt it = _order.begin(); it != _order.end(); ++it)
+  {
+    if (_parent[*it] == -2 && insert(*it, randomize))
+    {
+      ++res;
+    }
+  }
+  return res;
+}
+
+bool HeuristicSolver::movePass()
+{
+  // move the subtree of v to another parent if that makes room for new vertices
+  for (StlIntVectorIt it = _order.begin(); it != _order.end() && !timeUp(); ++it)
+  {
+    int v = *it;
+    int u = _parent[v];
+    if (u < 0)
+    {
+      continue;
+    }
+    
+    for (StlIntVectorIt it2 = _inArcs[v].begin(); it2 != _inArcs[v].end(); ++it2)
+    {
+      int w = *it2;
+      if (w == u || _parent[w] == -2)
+      {
+        continue;
+      }
+      
+      // as G is a DAG, w is not in the subtree of v
+      detach(v);
+      if (attach(v, w))
+      {
+        if (insertAll(false) > 0)
+        {
+          return true;
+        }
+        detach(v);
+      }
+      bool restored = attach(v, u);
+      assert(restored);
+    }
+  }
+  
+  return false;
+}
+
+bool HeuristicSolver::swapPass()
+{
+  // remove a leaf v if that makes room for at least two new vertices
+  for (StlIntVectorIt it = _order.begin(); it != _order.end() && !timeUp(); ++it)
+  {
+    int v = *it;
+    int u = _parent[v];
+    if (u < 0 || !_children[v].empty())
+    {
+      continue;
+    }
+    
+    StlIntVector before = _parent;
+    detach(v);
+    
+    StlIntVector inserted;
+    for (StlIntVectorIt it2 = _order.begin(); it2 != _order.end(); ++it2)
+    {
+      if (*it2 != v && _parent[*it2] == -2 && insert(*it2, false))
+      {
+        inserted.push_back(*it2);
+      }
+    }
+    
+    if (inserted.size() >= 2)
+    {
+      return true;
+    }
+    
+    // undo, inserted vertices are leaves that were added after v was removed
+    for (StlIntVector::const_reverse_iterator it2 = inserted.rbegin(); it2 != inserted.rend(); ++it2)
+    {
+      detach(*it2);
+    }
+    _need[v] = _lb[v];
+    _childSum[v] = StlDoubleVector(_m, 0);
+    bool restored = attach(v, u);
+    assert(restored);
+    assert(_parent == before);
+  }
+  
+  return false;
+}
+
+void HeuristicSolver::updateBest()
+{
+  if (_size > _bestSize)
+  {
+    _bestSize = _size;
+    _bestParent = _parent;
+  }
+}
+
+void HeuristicSolver::load(const StlIntVector& parent)
+{
+  init(std::find(parent.begin(), parent.end(), -1) - parent.begin());
+  for (StlIntVectorIt it = _order.begin(); it != _order.end(); ++it)
+  {
+    int v = *it;
+    if (parent[v] >= 0)
+    {
+      bool attached = attach(v, parent[v]);
+      assert(attached);
+    }
+  }
+}
+
+void HeuristicSolver::removeSubtree(int v)
+{
+  StlIntVector subtree(1, v);
+  for (size_t idx = 0; idx < subtree.size(); ++idx)
+  {
+    const StlIntVector& C = _children[subtree[idx]];
+    subtree.insert(subtree.end(), C.begin(), C.end());
+  }
+  
+  detach(v);
+  for (size_t idx = 1; idx < subtree.size(); ++idx)
+  {
+    _parent[subtree[idx]] = -2;
+    --_size;
+  }
+  for (StlIntVectorIt it = subtree.begin(); it != subtree.end(); ++it)
+  {
+    _children[*it].clear();
+  }
+}
+
+void HeuristicSolver::localSearch()
+{
+  while (!timeUp() && (movePass() || swapPass()))
+  {
+    insertAll(false);
+    updateBest();
+    ++_nrImprovements;
+  }
+}
+
+bool HeuristicSolver::solve(MaxSolution& solution)
+{
+  _timer.restart();
+  _bestSize = 0;
+  _nrImprovements = 0;
+  
+  // greedy construction from every root candidate
+  typedef std::pair<int, int> IntPair;
+  typedef std::vector<IntPair> IntPairVector;
+  IntPairVector roots;
+  for (StlIntVectorIt it = _order.begin(); it != _order.end(); ++it)
+  {
+    int root = *it;
+    if (_rootCandidate[root] && feasible(root))
+    {
+      init(root);
+      insertAll(false);
+      updateBest();
+      roots.push_back(IntPair(-_size, root));
+    }
+  }
+  
+  if (roots.empty())
+  {
+    return false;
+  }
+  
+  // local search starting from the largest greedy trees, the others are
+  // only considered if there is a time limit
+  std::sort(roots.begin(), roots.end());
+  for (IntPairVector::const_iterator it = roots.begin(); it != roots.end() && !timeUp(); ++it)
+  {
+    if (_timeLimit <= 0 && it->first != roots.front().first)
+    {
+      break;
+    }
+    
+    init(it->second);
+    insertAll(false);
+    localSearch();
+  }
+  
+  // with time left, perturb the best tree by removing a random subtree or
+  // start over from a random root, reinserting vertices below random parents
+  _rng.seed(0);
+  while (_timeLimit > 0 && !timeUp())
+  {
+    if (_bestSize > 1 && _rng() % 2 == 0)
+    {
+      load(_bestParent);
+      
+      StlIntVector candidates;
+      for (int j = 0; j < _n; ++j)
+      {
+        if (_parent[j] >= 0)
+        {
+          candidates.push_back(j);
+        }
+      }
+      removeSubtree(candidates[_rng() % candidates.size()]);
+    }
+    else
+    {
+      init(roots[_rng() % roots.size()].second);
+    }
+    
+    insertAll(true);
+    updateBest();
+    localSearch();
+  }
+  
+  StlDoubleMatrix f;
+  if (!computeFrequencies(_bestParent, f))
+  {
+    return false;
+  }
+  
+  MaxSolution::Triple sol;
+  constructSolution(_bestParent, f, sol);
+  solution.clear();
+  solution.add(sol);
+  
+  _objValue = _bestSize - deviation(f);
+  std::cerr << "[" << _objValue << ", heuristic, " << _nrImprovements << " improvements]" << std::endl;
+  
+  return true;
+}
+
+} // namespace vaff
@@ -0,0 +1,125 @@
+/*
+ *  heuristicsolver.h
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#ifndef HEURISTICSOLVER_H
+#define HEURISTICSOLVER_H
+
+#include "solver.h"
+#include <lemon/time_measure.h>
+#include <random>
+
+namespace vaff {
+
+// anytime heuristic: grows a maximal tree greedily in topological order from
+// every root candidate and improves these trees by local search (subtree
+// moves and leaf swaps); any time left is spent perturbing the best tree
+class HeuristicSolver : public Solver
+{
+public:
+  HeuristicSolver(const BaseAncestryGraph& G,
+                  const RealIntervalMatrix& F_interval_clustered,
+                  const RealMatrix& F_point_unclustered,
+                  const StlIntMatrix& toUnclusteredColumn,
+                  int timeLimit);
+  
+  bool solve(MaxSolution& solution);
+  
+  void applyPresolve(const StlBoolVector& rootCandidate)
+  {
+    _rootCandidate = rootCandidate;
+  }
+  
+  double getObjValue() const
+  {
+    return _objValue;
+  }
+  
+  // parent[j] as in computeFrequencies of the best tree found
+  const StlIntVector& getParent() const
+  {
+    return _bestParent;
+  }
+
+private:
+  const int _n;
+  const int _m;
+  
+  StlIntVector _order;
+  // _inArcs[j] : columns of the in-neighbors of v_j
+  StlIntMatrix _inArcs;
+  StlBoolVector _rootCandidate;
+  // _lb[j][i] and _ub[j][i] : bounds on f[i][j]
+  StlDoubleMatrix _lb;
+  StlDoubleMatrix _ub;
+  
+  // current tree, _need[j][i] is the smallest f[i][j] that accommodates
+  // the subtree of v_j and _childSum[j][i] sums _need over its children
+  StlIntVector _parent;
+  StlIntMatrix _children;
+  StlDoubleMatrix _need;
+  StlDoubleMatrix _childSum;
+  int _size;
+  
+  StlIntVector _bestParent;
+  int _bestSize;
+  int _nrImprovements;
+  
+  lemon::Timer _timer;
+  std::mt19937 _rng;
+  double _objValue;
+  
+  bool timeUp() const
+  {
+    return _timeLimit > 0 && _timer.realTime() > _timeLimit;
+  }
+  
+  // a cluster whose CI lower bound exceeds 0.5 cannot be a tree vertex
+  bool feasible(int j) const
+  {
+    for (int i = 0; i < _m; ++i)
+    {
+      if (g_tol.less(_ub[j][i], _lb[j][i]))
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+  
+  void init(int root);
+  
+  // adds delta to _childSum[j] and updates _need on the path to the root,
+  // only checks feasibility if apply is false
+  bool propagate(int j, const StlDoubleVector& delta, bool apply);
+  
+  bool attach(int v, int u);
+  
+  void detach(int v);
+  
+  // attaches v to its in-tree in-neighbor with the largest remaining
+  // capacity or to a random one
+  bool insert(int v, bool randomize);
+  
+  int insertAll(bool randomize);
+  
+  bool movePass();
+  
+  bool swapPass();
+  
+  void updateBest();
+  
+  // rebuilds the tree given by parent
+  void load(const StlIntVector& parent);
+  
+  void removeSubtree(int v);
+  
+  void localSearch();
+};
+
+} // namespace vaff
+
+#endif // HEURISTICSOLVER_H
@@ -0,0 +1,233 @@
+/*
+ *  hierarchicalsolver.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "hierarchicalsolver.h"
+#include "presolver.h"
+
+namespace vaff {
+
+HierarchicalSolver::HierarchicalSolver(const BaseAncestryGraph& G,
+                                       const RealIntervalMatrix& F_interval_clustered,
+                                       const RealMatrix& F_point_unclustered,
+                                       const StlIntMatrix& toUnclusteredColumn,
+                                       const BaseAncestryGraph& coarseG,
+                                       const RealIntervalMatrix& coarseF_interval_clustered,
+                                       const StlIntMatrix& coarseToUnclusteredColumn,
+                                       int timeLimit,
+                                       IntMaxIlpSolver::Formulation formulation,
+                                       const std::string& backend)
+  : Solver(G, F_interval_clustered, F_point_unclustered, toUnclusteredColumn, timeLimit)
+  , _coarseG(coarseG)
+  , _coarseF_interval_clustered(coarseF_interval_clustered)
+  , _coarseToUnclusteredColumn(coarseToUnclusteredColumn)
+  , _formulation(formulation)
+  , _backend(backend)
+  , _timer()
+  , _optimal(false)
+  , _objValue(0)
+  , _coarseSize(0)
+  , _nrRestrictedArcs(0)
+{
+}
+
+int HierarchicalSolver::remainingTime() const
+{
+  if (_timeLimit <= 0)
+  {
+    return -1;
+  }
+  return std::max(0, _timeLimit - static_cast<int>(_timer.realTime()));
+}
+
+bool HierarchicalSolver::solveCoarse(MaxSolution& coarseSolution,
+                                     StlIntVector& coarseParent)
+{
+  const int coarse_n = _coarseF_interval_clustered.getNrCols();
+  
+  StlIntVector columns(coarse_n);
+  for (int c = 0; c < coarse_n; ++c)
+  {
+    columns[c] = c;
+  }
+  BaseAncestryGraph coarseH;
+  _coarseG.induce(columns, coarseH);
+  
+  Presolver presolver(coarseH, _coarseF_interval_clustered);
+  presolver.run();
+  
+  // the coarse level gets half of the time limit
+  int timeLimit = _timeLimit > 0 ? std::max(1, _timeLimit / 2) : -1;
+  IntMaxIlpSolver ilp(coarseH,
+                      _coarseF_interval_clustered,
+                      _F_point_unclustered,
+                      _coarseToUnclusteredColumn,
+                      timeLimit,
+                      _formulation,
+                      _backend);
+  ilp.applyPresolve(presolver.getRootCandidates(),
+                    presolver.getNonRootIntervals());
+  if (!ilp.solve(coarseSolution) || coarseSolution.size() == 0)
+  {
+    return false;
+  }
+  
+  if (timeLimit > 0 && _timer.realTime() >= timeLimit)
+  {
+    _optimal = false;
+  }
+  
+  return ilp.mapSolution(coarseSolution.solution(0), coarseParent);
+}
+
+bool HierarchicalSolver::solve(MaxSolution& solution)
+{
+  const int n = _F_interval_clustered.getNrCols();
+  const int coarse_n = _coarseF_interval_clustered.getNrCols();
+  const int org_n = _F_point_unclustered.getNrCols();
+  
+  _timer.restart();
+  _optimal = true;
+  
+  MaxSolution coarseSolution(_F_point_unclustered);
+  StlIntVector coarseParent;
+  if (!solveCoarse(coarseSolution, coarseParent))
+  {
+    return false;
+  }
+  
+  // ancestor[c][d] : coarse cluster c equals or is an ancestor of d in the coarse tree
+  StlBoolMatrix ancestor(coarse_n, StlBoolVector(coarse_n, false));
+  int coarseRoot = -1;
+  _coarseSize = 0;
+  for (int d = 0; d < coarse_n; ++d)
+  {
+    if (coarseParent[d] == -2)
+    {
+      continue;
+    }
+    
+    ++_coarseSize;
+    if (coarseParent[d] == -1)
+    {
+      coarseRoot = d;
+    }
+    for (int c = d; c >= 0; c = coarseParent[c])
+    {
+      ancestor[c][d] = true;
+    }
+  }
+  
+  // every column of G belongs to the coarse cluster holding most of its mutations
+  StlIntVector orgToCoarse(org_n, -1);
+  for (int c = 0; c < coarse_n; ++c)
+  {
+    const StlIntVector& M = _coarseToUnclusteredColumn[c];
+    for (StlIntVectorIt it = M.begin(); it != M.end(); ++it)
+    {
+      orgToCoarse[*it] = c;
+    }
+  }
+  StlIntVector toCoarse(n, -1);
+  StlIntVector count(coarse_n, 0);
+  for (int j = 0; j < n; ++j)
+  {
+    std::fill(count.begin(), count.end(), 0);
+    int bestCount = 0;
+    const StlIntVector& M = _toUnclusteredColumn[j];
+    for (StlIntVectorIt it = M.begin(); it != M.end(); ++it)
+    {
+      int c = orgToCoarse[*it];
+      if (c != -1 && ++count[c] > bestCount)
+      {
+        bestCount = count[c];
+        toCoarse[j] = c;
+      }
+    }
+  }
+  
+  // restrict G to the arcs that are consistent with the coarse tree
+  StlIntVector columns(n);
+  for (int j = 0; j < n; ++j)
+  {
+    columns[j] = j;
+  }
+  BaseAncestryGraph H;
+  _G.induce(columns, H);
+  
+  const Digraph& g = H.getG();
+  std::vector<Arc> inconsistent;
+  for (ArcIt a(g); a != lemon::INVALID; ++a)
+  {
+    int c = toCoarse[H.mapNodeToColumn(g.source(a))];
+    int d = toCoarse[H.mapNodeToColumn(g.target(a))];
+    if (c == -1 || d == -1 || !ancestor[c][d])
+    {
+      inconsistent.push_back(a);
+    }
+  }
+  for (std::vector<Arc>::const_iterator it = inconsistent.begin(); it != inconsistent.end(); ++it)
+  {
+    H.removeArc(*it);
+  }
+  _nrRestrictedArcs = lemon::countArcs(g);
+  
+  Presolver presolver(H, _F_interval_clustered);
+  presolver.run();
+  
+  // the root lies in the coarse root, unless none of its columns can be the root
+  StlBoolVector rootCandidate(presolver.getRootCandidates());
+  bool rootRestricted = false;
+  for (int j = 0; j < n; ++j)
+  {
+    if (toCoarse[j] == coarseRoot && rootCandidate[j])
+    {
+      rootRestricted = true;
+    }
+  }
+  for (int j = 0; j < n && rootRestricted; ++j)
+  {
+    if (toCoarse[j] != coarseRoot)
+    {
+      rootCandidate[j] = false;
+    }
+  }
+  
+  int timeLimit = remainingTime();
+  if (timeLimit == 0)
+  {
+    _optimal = false;
+    return false;
+  }
+  
+  IntMaxIlpSolver ilp(H,
+                      _F_interval_clustered,
+                      _F_point_unclustered,
+                      _toUnclusteredColumn,
+                      timeLimit,
+                      _formulation,
+                      _backend);
+  ilp.applyPresolve(rootCandidate, presolver.getNonRootIntervals());
+  ilp.setMipStart(coarseSolution.solution(0));
+  if (!ilp.solve(solution) || solution.size() == 0)
+  {
+    return false;
+  }
+  
+  if (_timeLimit > 0 && _timer.realTime() >= _timeLimit)
+  {
+    _optimal = false;
+  }
+  _objValue = ilp.getObjValue();
+  
+  std::cerr << "[" << _objValue << ", " << (_optimal ? "optimal" : "time limit")
+            << " on " << _nrRestrictedArcs << " of " << lemon::countArcs(_G.getG()) << " arcs, "
+            << _coarseSize << " of " << coarse_n << " coarse clusters]" << std::endl;
+  
+  return true;
+}
+
+} // namespace vaff
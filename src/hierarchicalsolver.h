@@ -0,0 +1,86 @@
+/*
+ *  hierarchicalsolver.h
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#ifndef HIERARCHICALSOLVER_H
+#define HIERARCHICALSOLVER_H
+
+#include "intmaxilpsolver.h"
+#include <lemon/time_measure.h>
+
+namespace vaff {
+
+// solves the ILP on a coarse clustering of the same mutations first, e.g.
+// obtained with a larger alpha, and then on G restricted to the arcs
+// (v_j,v_k) where the coarse cluster of v_j equals or is an ancestor of the
+// coarse cluster of v_k in the coarse tree; the root is taken from the
+// coarse root and clusters outside the coarse tree are dropped, so the
+// resulting tree is feasible but not necessarily optimal for G
+class HierarchicalSolver : public Solver
+{
+public:
+  HierarchicalSolver(const BaseAncestryGraph& G,
+                     const RealIntervalMatrix& F_interval_clustered,
+                     const RealMatrix& F_point_unclustered,
+                     const StlIntMatrix& toUnclusteredColumn,
+                     const BaseAncestryGraph& coarseG,
+                     const RealIntervalMatrix& coarseF_interval_clustered,
+                     const StlIntMatrix& coarseToUnclusteredColumn,
+                     int timeLimit,
+                     IntMaxIlpSolver::Formulation formulation = IntMaxIlpSolver::PRODUCT_FORMULATION,
+                     const std::string& backend = "");
+  
+  // both levels are presolved
+  bool solve(MaxSolution& solution);
+  
+  // false if either level hit the time limit, the tree is only optimal for
+  // the restricted graph
+  bool isOptimal() const
+  {
+    return _optimal;
+  }
+  
+  double getObjValue() const
+  {
+    return _objValue;
+  }
+  
+  // number of coarse clusters in the coarse tree
+  int getCoarseSize() const
+  {
+    return _coarseSize;
+  }
+  
+  // number of arcs of G that are consistent with the coarse tree
+  int getNrRestrictedArcs() const
+  {
+    return _nrRestrictedArcs;
+  }
+
+private:
+  const BaseAncestryGraph& _coarseG;
+  const RealIntervalMatrix& _coarseF_interval_clustered;
+  const StlIntMatrix& _coarseToUnclusteredColumn;
+  const IntMaxIlpSolver::Formulation _formulation;
+  const std::string _backend;
+  
+  lemon::Timer _timer;
+  bool _optimal;
+  double _objValue;
+  int _coarseSize;
+  int _nrRestrictedArcs;
+  
+  // remaining time, -1 if there is no time limit and 0 if it has been hit
+  int remainingTime() const;
+  
+  // solves the coarse ILP, coarseParent is as in computeFrequencies
+  bool solveCoarse(MaxSolution& coarseSolution,
+                   StlIntVector& coarseParent);
+};
+
+} // namespace vaff
+
+#endif // HIERARCHICALSOLVER_H
@@ -0,0 +1,196 @@
+/*
+ *  highsbackend.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "highsbackend.h"
+#include <cmath>
+
+namespace vaff {
+
+HighsBackend::HighsBackend()
+  : _highs()
+  , _lp()
+  , _values()
+  , _pIncumbentListener(NULL)
+  , _pProgressListener(NULL)
+{
+  _highs.setOptionValue("output_flag", false);
+}
+
+void HighsBackend::load(const MilpModel& model)
+{
+  const int nrCols = model.getNrCols();
+  const int nrRows = model.getNrRows() - model.getNrLazyRows();
+  
+  // both use IEEE infinity, so bounds are passed as is
+  _lp.num_col_ = nrCols;
+  _lp.num_row_ = nrRows;
+  _lp.sense_ = model.isMaximize() ? ObjSense::kMaximize : ObjSense::kMinimize;
+  _lp.col_cost_.resize(nrCols);
+  _lp.col_lower_.resize(nrCols);
+  _lp.col_upper_.resize(nrCols);
+  _lp.integrality_.resize(nrCols);
+  for (int j = 0; j < nrCols; ++j)
+  {
+    _lp.col_cost_[j] = model.getColObj(j);
+    _lp.col_lower_[j] = model.getColLB(j);
+    _lp.col_upper_[j] = model.getColUB(j);
+    _lp.integrality_[j] = model.getColType(j) == MilpModel::BINARY ? HighsVarType::kInteger
+                                                                   : HighsVarType::kContinuous;
+  }
+  
+  // lazy rows are left out
+  _lp.row_lower_.clear();
+  _lp.row_upper_.clear();
+  _lp.a_matrix_.format_ = MatrixFormat::kRowwise;
+  _lp.a_matrix_.num_col_ = nrCols;
+  _lp.a_matrix_.num_row_ = nrRows;
+  _lp.a_matrix_.start_.assign(1, 0);
+  _lp.a_matrix_.index_.clear();
+  _lp.a_matrix_.value_.clear();
+  for (int r = 0; r < model.getNrRows(); ++r)
+  {
+    if (model.isRowLazy(r))
+    {
+      continue;
+    }
+    
+    _lp.row_lower_.push_back(model.getRowLB(r));
+    _lp.row_upper_.push_back(model.getRowUB(r));
+    for (int k = model.getRowStart(r); k < model.getRowStart(r + 1); ++k)
+    {
+      _lp.a_matrix_.index_.push_back(model.getRowIndex(k));
+      _lp.a_matrix_.value_.push_back(model.getRowValue(k));
+    }
+    _lp.a_matrix_.start_.push_back(_lp.a_matrix_.index_.size());
+  }
+  
+  _highs.passModel(_lp);
+}
+
+void HighsBackend::callback(int callbackType,
+                            const std::string& message,
+                            const HighsCallbackDataOut* pDataOut,
+                            HighsCallbackDataIn* pDataIn,
+                            void* pUserData)
+{
+  const HighsBackend* pBackend = static_cast<const HighsBackend*>(pUserData);
+  if (callbackType == kCallbackMipInterrupt && pBackend->_pProgressListener)
+  {
+    // the primal bound is infinite as long as there is no incumbent
+    double objValue = pDataOut->mip_primal_bound;
+    pBackend->_pProgressListener->progress(pDataOut->mip_node_count,
+                                           std::isfinite(objValue),
+                                           objValue,
+                                           pDataOut->mip_dual_bound);
+  }
+  else if (callbackType == kCallbackMipImprovingSolution && pBackend->_pIncumbentListener)
+  {
+    StlDoubleVector values(pDataOut->mip_solution,
+                           pDataOut->mip_solution + pBackend->_lp.num_col_);
+    pBackend->_pIncumbentListener->improved(values,
+                                            pDataOut->mip_primal_bound,
+                                            pDataOut->mip_dual_bound);
+  }
+}
+
+void HighsBackend::setIncumbentListener(MilpIncumbentListener* pListener)
+{
+  _pIncumbentListener = pListener;
+  if (pListener)
+  {
+    _highs.setCallback(callback, this);
+    _highs.startCallback(kCallbackMipImprovingSolution);
+  }
+}
+
+void HighsBackend::setProgressListener(MilpProgressListener* pListener)
+{
+  _pProgressListener = pListener;
+  if (pListener)
+  {
+    _highs.setCallback(callback, this);
+    _highs.startCallback(kCallbackMipInterrupt);
+  }
+}
+
+void HighsBackend::setMipStart(const StlDoubleVector& values)
+{
+  assert(static_cast<int>(values.size()) == _lp.num_col_);
+  
+  // passModel discards the solution, so the start is set afterwards
+  HighsSolution start;
+  start.value_valid = true;
+  start.col_value = values;
+  _highs.setSolution(start);
+}
+
+void HighsBackend::setColBounds(int col, double lb, double ub)
+{
+  _lp.col_lower_[col] = lb;
+  _lp.col_upper_[col] = ub;
+  _highs.changeColBounds(col, lb, ub);
+}
+
+void HighsBackend::addRow(const MilpRow& row, double lb, double ub)
+{
+  const StlIntVector& index = row.getIndices();
+  const StlDoubleVector& value = row.getValues();
+  
+  // _lp is kept in sync for solveRelaxation
+  _lp.row_lower_.push_back(lb);
+  _lp.row_upper_.push_back(ub);
+  _lp.a_matrix_.index_.insert(_lp.a_matrix_.index_.end(), index.begin(), index.end());
+  _lp.a_matrix_.value_.insert(_lp.a_matrix_.value_.end(), value.begin(), value.end());
+  _lp.a_matrix_.start_.push_back(_lp.a_matrix_.index_.size());
+  ++_lp.num_row_;
+  ++_lp.a_matrix_.num_row_;
+  
+  _highs.addRow(lb, ub, row.size(), &index[0], &value[0]);
+}
+
+bool HighsBackend::solve(int timeLimit)
+{
+  if (timeLimit > 0)
+  {
+    _highs.setOptionValue("time_limit", static_cast<double>(timeLimit));
+  }
+  
+  _values.clear();
+  if (_highs.run() == HighsStatus::kError)
+  {
+    return false;
+  }
+  
+  if (_highs.getInfo().primal_solution_status != kSolutionStatusFeasible)
+  {
+    return false;
+  }
+  
+  _values = _highs.getSolution().col_value;
+  return true;
+}
+
+double HighsBackend::solveRelaxation()
+{
+  HighsLp relaxation = _lp;
+  relaxation.integrality_.clear();
+  
+  Highs highs;
+  highs.setOptionValue("output_flag", false);
+  highs.passModel(relaxation);
+  
+  double bound = -1;
+  if (highs.run() == HighsStatus::kOk
+      && highs.getModelStatus() == HighsModelStatus::kOptimal)
+  {
+    bound = highs.getInfo().objective_function_value;
+  }
+  
+  return bound;
+}
+
+} // namespace vaff
@@ -0,0 +1,87 @@
+/*
+ *  highsbackend.h
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#ifndef HIGHSBACKEND_H
+#define HIGHSBACKEND_H
+
+#include "milpbackend.h"
+#include <Highs.h>
+
+namespace vaff {
+
+// HiGHS keeps no solution pool, only the incumbent is reported; its thread
+// pool is shared by all instances, so setNrThreads is ignored
+class HighsBackend : public MilpBackend
+{
+public:
+  HighsBackend();
+  
+  std::string getName() const
+  {
+    return "highs";
+  }
+  
+  void load(const MilpModel& model);
+  
+  void setIncumbentListener(MilpIncumbentListener* pListener);
+  
+  void setProgressListener(MilpProgressListener* pListener);
+  
+  void setMipStart(const StlDoubleVector& values);
+  
+  void setColBounds(int col, double lb, double ub);
+  
+  void addRow(const MilpRow& row, double lb, double ub);
+  
+  bool solve(int timeLimit);
+  
+  double solveRelaxation();
+  
+  double getObjValue() const
+  {
+    return _highs.getInfo().objective_function_value;
+  }
+  
+  int getNrSolutions() const
+  {
+    return _values.empty() ? 0 : 1;
+  }
+  
+  double getObjValue(int solIdx) const
+  {
+    assert(solIdx == 0);
+    return getObjValue();
+  }
+  
+  double getBestObjValue() const
+  {
+    return _highs.getInfo().mip_dual_bound;
+  }
+  
+  void getValues(int solIdx, StlDoubleVector& values) const
+  {
+    assert(solIdx == 0);
+    values = _values;
+  }
+
+private:
+  Highs _highs;
+  HighsLp _lp;
+  StlDoubleVector _values;
+  MilpIncumbentListener* _pIncumbentListener;
+  MilpProgressListener* _pProgressListener;
+  
+  static void callback(int callbackType,
+                       const std::string& message,
+                       const HighsCallbackDataOut* pDataOut,
+                       HighsCallbackDataIn* pDataIn,
+                       void* pUserData);
+};
+
+} // namespace vaff
+
+#endif // HIGHSBACKEND_H
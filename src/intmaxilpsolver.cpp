@@ -7,20 +7,353 @@
 
 #include "intmaxilpsolver.h"
 #include <lemon/bfs.h>
-#include <lemon/adaptors.h>
+#include <lemon/time_measure.h>
+#include <fstream>
+#include <set>
+#include <mutex>
+#include <cstdio>
+#include <sstream>
+#include <sys/resource.h>
 
 namespace vaff {
   
+// separates sum rule covers: children C of v_j with sum_k LB(i,k) > UB(i,j)
+// cannot all be attached to v_j, hence sum_{k in C} x[(j,k)] <= |C| - 1
+class CoverCutSeparator : public MilpCutSeparator
+{
+public:
+  CoverCutSeparator(const StlIntVector& x,
+                    const StlIntMatrix& outArcIndex,
+                    const StlIntMatrix& outArcTarget,
+                    const RealIntervalMatrix& F_interval_clustered)
+    : _x(x)
+    , _outArcIndex(outArcIndex)
+    , _outArcTarget(outArcTarget)
+    , _F_interval_clustered(F_interval_clustered)
+  {
+  }
+  
+  void separate(const StlDoubleVector& values,
+                MilpRowVector& rows,
+                StlDoubleVector& ub) const;
+  
+private:
+  typedef std::pair<double, int> DoubleIntPair;
+  typedef std::vector<DoubleIntPair> DoubleIntPairVector;
+  
+  const StlIntVector& _x;
+  const StlIntMatrix& _outArcIndex;
+  const StlIntMatrix& _outArcTarget;
+  const RealIntervalMatrix& _F_interval_clustered;
+};
+  
+void CoverCutSeparator::separate(const StlDoubleVector& values,
+                                 MilpRowVector& rows,
+                                 StlDoubleVector& ub) const
+{
+  const int m = _F_interval_clustered.getNrRows();
+  const int n = _outArcIndex.size();
+  
+  DoubleIntPairVector items;
+  StlIntVector cover;
+  for (int j = 0; j < n; ++j)
+  {
+    const StlIntVector& arcs = _outArcIndex[j];
+    const StlIntVector& targets = _outArcTarget[j];
+    const int d = arcs.size();
+    
+    // covers with at most two children are added statically
+    if (d < 3)
+    {
+      continue;
+    }
+    
+    for (int i = 0; i < m; ++i)
+    {
+      const double cap = std::min(0.5, _F_interval_clustered(i, j).second);
+      
+      double total = 0;
+      items.clear();
+      for (int t = 0; t < d; ++t)
+      {
+        double lb = _F_interval_clustered(i, targets[t]).first;
+        if (g_tol.positive(lb))
+        {
+          items.push_back(DoubleIntPair((1 - values[_x[arcs[t]]]) / lb, t));
+          total += lb;
+        }
+      }
+      
+      if (!g_tol.less(cap, total))
+      {
+        continue;
+      }
+      
+      // greedily pick children with a large x value relative to their weight
+      std::sort(items.begin(), items.end());
+      double weight = 0;
+      cover.clear();
+      for (DoubleIntPairVector::const_iterator it = items.begin(); it != items.end(); ++it)
+      {
+        cover.push_back(it->second);
+        weight += _F_interval_clustered(i, targets[it->second]).first;
+        if (g_tol.less(cap, weight))
+        {
+          break;
+        }
+      }
+      
+      // make the cover minimal, dropping the least attractive children first
+      for (int c = cover.size() - 1; c >= 0; --c)
+      {
+        double lb = _F_interval_clustered(i, targets[cover[c]]).first;
+        if (g_tol.less(cap, weight - lb))
+        {
+          weight -= lb;
+          cover.erase(cover.begin() + c);
+        }
+      }
+      
+      if (cover.size() < 3)
+      {
+        continue;
+      }
+      
+      double lhs = 0;
+      for (StlIntVectorIt it = cover.begin(); it != cover.end(); ++it)
+      {
+        lhs += values[_x[arcs[*it]]];
+      }
+      
+      if (lhs > cover.size() - 1 + 1e-3)
+      {
+        MilpRow row;
+        for (StlIntVectorIt it = cover.begin(); it != cover.end(); ++it)
+        {
+          row.add(_x[arcs[*it]], 1);
+        }
+        rows.push_back(row);
+        ub.push_back(cover.size() - 1);
+      }
+    }
+  }
+}
+  
+// writes every improving incumbent to a temporary file that is renamed to
+// the output file, so the latter is complete whenever the process is killed
+class IncumbentWriter : public MilpIncumbentListener
+{
+public:
+  IncumbentWriter(const IntMaxIlpSolver& solver,
+                  const std::string& filename)
+    : _solver(solver)
+    , _filename(filename)
+    , _mutex()
+    , _written(false)
+    , _objValue(0)
+    , _timer()
+  {
+  }
+  
+  void improved(const StlDoubleVector& values,
+                double objValue,
+                double bound);
+
+private:
+  const IntMaxIlpSolver& _solver;
+  const std::string _filename;
+  std::mutex _mutex;
+  bool _written;
+  double _objValue;
+  lemon::Timer _timer;
+};
+
+void IncumbentWriter::improved(const StlDoubleVector& values,
+                               double objValue,
+                               double bound)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  
+  // the ILP is a maximization problem
+  if (_written && !g_tol.less(_objValue, objValue))
+  {
+    return;
+  }
+  
+  // incumbents of backends without lazy rows may violate the left out rows
+  const MilpModel& model = _solver._model;
+  if (model.getNrLazyRows() > 0 && !_solver._pBackend->supportsLazyRows()
+      && model.countViolations(values, 1e-5) > 0)
+  {
+    return;
+  }
+  
+  MaxSolution::Triple sol;
+  _solver.processSolution(values, sol);
+  
+  std::string tmpFilename = _filename + ".tmp";
+  std::ofstream out(tmpFilename.c_str());
+  if (!out.good())
+  {
+    return;
+  }
+  
+  double gap = fabs(bound - objValue) / (1e-10 + fabs(objValue));
+  out << 1 << " #sols, objective: " << objValue << ", bound: " << bound
+      << ", gap: " << 100 * gap << "%, time: " << _timer.realTime() << "s" << std::endl;
+  out << std::endl;
+  out << _solver._F_point_unclustered;
+  out << std::endl;
+  out << sol;
+  out << std::endl;
+  out.close();
+  
+  if (out.good() && std::rename(tmpFilename.c_str(), _filename.c_str()) == 0)
+  {
+    _written = true;
+    _objValue = objValue;
+    std::cerr << "Incumbent: " << objValue << ", bound: " << bound << std::endl;
+  }
+}
+
+// peak resident set size in kB
+static long peakMemory()
+{
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+  {
+    return -1;
+  }
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+}
+
+// JSON has no infinity
+static void writeJsonNumber(std::ostream& out, double value)
+{
+  if (std::isfinite(value))
+  {
+    out << value;
+  }
+  else
+  {
+    out << "null";
+  }
+}
+
+static double relativeGap(double objValue, double bound)
+{
+  return fabs(bound - objValue) / (1e-10 + fabs(objValue));
+}
+
+// writes one JSON object per line: the events of the solver as they occur
+// and the progress of the backend at most once every interval seconds
+class TelemetryWriter : public MilpProgressListener
+{
+public:
+  TelemetryWriter(const std::string& filename,
+                  double interval)
+    : _out(filename.c_str())
+    , _interval(interval)
+    , _mutex()
+    , _timer()
+    , _lastProgress(-1)
+  {
+  }
+  
+  bool good() const
+  {
+    return _out.good();
+  }
+  
+  // fields are the remaining members of the object, if any
+  void write(const std::string& event, const std::string& fields);
+  
+  void progress(long long nrNodes,
+                bool hasIncumbent,
+                double objValue,
+                double bound);
+
+private:
+  std::ofstream _out;
+  const double _interval;
+  std::mutex _mutex;
+  lemon::Timer _timer;
+  double _lastProgress;
+  
+  void writeLine(const std::string& event, const std::string& fields);
+};
+
+void TelemetryWriter::writeLine(const std::string& event,
+                                const std::string& fields)
+{
+  _out << "{\"event\": \"" << event << "\", \"time\": " << _timer.realTime()
+       << ", \"peak_rss_kb\": " << peakMemory();
+  if (!fields.empty())
+  {
+    _out << ", " << fields;
+  }
+  _out << "}" << std::endl;
+}
+
+void TelemetryWriter::write(const std::string& event,
+                            const std::string& fields)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  writeLine(event, fields);
+}
+
+void TelemetryWriter::progress(long long nrNodes,
+                               bool hasIncumbent,
+                               double objValue,
+                               double bound)
+{
+  std::lock_guard<std::mutex> lock(_mutex);
+  
+  double time = _timer.realTime();
+  if (_lastProgress >= 0 && time - _lastProgress < _interval)
+  {
+    return;
+  }
+  _lastProgress = time;
+  
+  std::ostringstream fields;
+  fields << "\"nodes\": " << nrNodes << ", \"incumbent\": ";
+  if (hasIncumbent)
+  {
+    writeJsonNumber(fields, objValue);
+  }
+  else
+  {
+    fields << "null";
+  }
+  fields << ", \"bound\": ";
+  writeJsonNumber(fields, bound);
+  fields << ", \"gap\": ";
+  if (hasIncumbent)
+  {
+    writeJsonNumber(fields, relativeGap(objValue, bound));
+  }
+  else
+  {
+    fields << "null";
+  }
+  
+  writeLine("progress", fields.str());
+}
+
 IntMaxIlpSolver::IntMaxIlpSolver(const BaseAncestryGraph& G,
                                  const RealIntervalMatrix& F_interval_clustered,
                                  const RealMatrix& F_point_unclustered,
                                  const StlIntMatrix& toUnclusteredColumn,
-                                 int timeLimit)
-  : _G(G)
-  , _F_interval_clustered(F_interval_clustered)
-  , _F_point_unclustered(F_point_unclustered)
-  , _toUnclusteredColumn(toUnclusteredColumn)
-  , _timeLimit(timeLimit)
+                                 int timeLimit,
+                                 Formulation formulation,
+                                 const std::string& backend)
+  : Solver(G, F_interval_clustered, F_point_unclustered, toUnclusteredColumn, timeLimit)
+  , _formulation(formulation)
   , _nodeCount(lemon::countNodes(_G.getG()))
   , _nodeToIndex(_G.getNodeToColumnMap())
   , _indexToNode(_G.getColumnToNodeVector())
@@ -28,212 +361,945 @@ IntMaxIlpSolver::IntMaxIlpSolver(const BaseAncestryGraph& G,
   , _arcCount(lemon::countArcs(_G.getG()))
   , _arcToIndex(_G.getG(), -1)
   , _indexToArc(_arcCount + _nodeCount, lemon::INVALID)
-  , _env()
-  , _model(_env)
-  , _cplex(_model)
+  , _model()
+  , _pBackend(MilpBackend::create(backend))
+  , _pCoverCutSeparator(NULL)
+  , _pIncumbentWriter(NULL)
+  , _pTelemetryWriter(NULL)
+  , _loaded(false)
+  , _mipStart()
+  , _nrThreads(0)
+  , _exhausted(false)
   , _x()
   , _f()
+  , _fxOffset()
+  , _fxToArcIndex()
+  , _arcIndexToFx()
   , _fx()
   , _g()
+  , _sampleRows()
+  , _familyName()
+  , _familyEnd()
+  , _nrFixedRoots(0)
+  , _nrTightenedProducts(0)
+  , _outArcIndex()
+  , _outArcTarget()
+{
+  assert(_G.isDAG());
+  assert(_pBackend);
+  
+  initVariables();
+  initConstraints();
+  initObjective();
+}
+  
+IntMaxIlpSolver::~IntMaxIlpSolver()
+{
+  delete _pBackend;
+  delete _pCoverCutSeparator;
+  delete _pIncumbentWriter;
+  delete _pTelemetryWriter;
+}
+  
+void IntMaxIlpSolver::load()
+{
+  if (_loaded)
+  {
+    return;
+  }
+  
+  _pBackend->load(_model);
+  if (_nrThreads > 0)
+  {
+    _pBackend->setNrThreads(_nrThreads);
+  }
+  if (_pCoverCutSeparator && _pBackend->supportsCutSeparator())
+  {
+    _pBackend->setCutSeparator(_pCoverCutSeparator);
+  }
+  if (_pIncumbentWriter)
+  {
+    _pBackend->setIncumbentListener(_pIncumbentWriter);
+  }
+  if (_pTelemetryWriter)
+  {
+    writeModelTelemetry();
+    _pBackend->setProgressListener(_pTelemetryWriter);
+  }
+  if (!_mipStart.empty())
+  {
+    _pBackend->setMipStart(_mipStart);
+  }
+  _loaded = true;
+}
+  
+bool IntMaxIlpSolver::setMipStart(const StlIntVector& parent)
+{
+  const Digraph& G = _G.getG();
+  const int m = _F_interval_clustered.getNrRows();
+  const int n = _F_interval_clustered.getNrCols();
+  
+  StlDoubleMatrix f;
+  if (!computeFrequencies(parent, f))
+  {
+    return false;
+  }
+  
+  _mipStart = StlDoubleVector(_model.getNrCols(), 0);
+  for (NodeIt v(G); v != lemon::INVALID; ++v)
+  {
+    if (parent[_nodeToIndex[v]] == -1)
+    {
+      _mipStart[_x[_nodeToRootArcIndex[v]]] = 1;
+    }
+  }
+  for (ArcIt a(G); a != lemon::INVALID; ++a)
+  {
+    if (parent[_nodeToIndex[G.target(a)]] == _nodeToIndex[G.source(a)])
+    {
+      _mipStart[_x[_arcToIndex[a]]] = 1;
+    }
+  }
+  
+  for (int i = 0; i < m; ++i)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      _mipStart[_f[i][j]] = f[i][j];
+      
+      // in both formulations fx is the product of f[i][j] and x[kl]
+      for (int p = _fxOffset[j]; p < _fxOffset[j + 1]; ++p)
+      {
+        _mipStart[_fx[i][p]] = f[i][j] * _mipStart[_x[_fxToArcIndex[p]]];
+      }
+      
+      const StlIntVector& M = _toUnclusteredColumn[j];
+      for (StlIntVectorIt it = M.begin(); it != M.end(); ++it)
+      {
+        _mipStart[_g[i][*it]] = fabs(std::min(0.5, _F_point_unclustered(i, *it)) - f[i][j]);
+      }
+    }
+  }
+  
+  // a tree from elsewhere may violate the root candidates or bounds of the presolve
+  if (_model.countViolations(_mipStart, 1e-6) > 0)
+  {
+    _mipStart.clear();
+    return false;
+  }
+  
+  if (_loaded)
+  {
+    _pBackend->setMipStart(_mipStart);
+  }
+  
+  return true;
+}
+  
+bool IntMaxIlpSolver::setMipStart(const MaxSolution::Triple& sol)
+{
+  const Digraph& G = _G.getG();
+  const int n = _F_interval_clustered.getNrCols();
+  
+  StlIntVector parent;
+  if (!mapSolution(sol, parent))
+  {
+    return false;
+  }
+  
+  // drop the subtrees below arcs that are disabled by update, removing
+  // vertices only relaxes the sum rule
+  bool changed = true;
+  while (changed)
+  {
+    changed = false;
+    for (int j = 0; j < n; ++j)
+    {
+      if (parent[j] < 0)
+      {
+        continue;
+      }
+      
+      Arc a = lemon::findArc(G, _indexToNode[parent[j]], _indexToNode[j]);
+      if (parent[parent[j]] == -2 || _model.getColUB(_x[_arcToIndex[a]]) == 0)
+      {
+        parent[j] = -2;
+        changed = true;
+      }
+    }
+  }
+  
+  return setMipStart(parent);
+}
+  
+int IntMaxIlpSolver::setLazySamples(int nrSeedSamples)
+{
+  assert(!_loaded);
+  
+  const int m = _F_point_unclustered.getNrRows();
+  
+  StlIntVector order;
+  sampleOrder(order);
+  
+  int res = 0;
+  for (int idx = std::max(0, nrSeedSamples); idx < m; ++idx)
+  {
+    const StlIntVector& rows = _sampleRows[order[idx]];
+    for (StlIntVectorIt it = rows.begin(); it != rows.end(); ++it)
+    {
+      _model.setRowLazy(*it, true);
+      ++res;
+    }
+  }
+  
+  return res;
+}
+  
+int IntMaxIlpSolver::activateViolatedSamples()
+{
+  const int m = _F_interval_clustered.getNrRows();
+  
+  StlDoubleVector values;
+  _pBackend->getValues(0, values);
+  
+  int res = 0;
+  for (int i = 0; i < m; ++i)
+  {
+    const StlIntVector& rows = _sampleRows[i];
+    if (rows.empty() || !_model.isRowLazy(rows.front()))
+    {
+      continue;
+    }
+    
+    bool violated = false;
+    for (StlIntVectorIt it = rows.begin(); it != rows.end() && !violated; ++it)
+    {
+      double activity = _model.getRowActivity(*it, values);
+      violated = activity < _model.getRowLB(*it) - 1e-6 || activity > _model.getRowUB(*it) + 1e-6;
+    }
+    
+    if (violated)
+    {
+      for (StlIntVectorIt it = rows.begin(); it != rows.end(); ++it)
+      {
+        _model.setRowLazy(*it, false);
+      }
+      ++res;
+    }
+  }
+  
+  if (res > 0)
+  {
+    std::string name = _pBackend->getName();
+    delete _pBackend;
+    _pBackend = MilpBackend::create(name);
+    _loaded = false;
+    load();
+  }
+  
+  return res;
+}
+  
+bool IntMaxIlpSolver::optimize(int timeLimit)
+{
+  lemon::Timer timer;
+  
+  int remaining = timeLimit;
+  while (true)
+  {
+    if (!_pBackend->solve(remaining))
+    {
+      return false;
+    }
+    
+    if (_pBackend->supportsLazyRows() || _model.getNrLazyRows() == 0)
+    {
+      break;
+    }
+    
+    int nrActivated = activateViolatedSamples();
+    if (nrActivated == 0)
+    {
+      break;
+    }
+    std::cerr << "Added the sum rule rows of " << nrActivated << " samples" << std::endl;
+    
+    if (timeLimit > 0)
+    {
+      remaining = timeLimit - static_cast<int>(timer.realTime());
+      if (remaining <= 0)
+      {
+        return false;
+      }
+    }
+  }
+  
+  return true;
+}
+  
+bool IntMaxIlpSolver::solve(MaxSolution& solution)
+{
+  load();
+  if (!optimize(_timeLimit))
+  {
+    if (_pTelemetryWriter)
+    {
+      writeResultTelemetry(false);
+    }
+    return false;
+  }
+  if (_pTelemetryWriter)
+  {
+    writeResultTelemetry(true);
+  }
+  
+  double obj_value = _pBackend->getObjValue();
+  
+  int nSol = _pBackend->getNrSolutions();
+  solution.clear();
+  
+  StlDoubleVector values;
+  for (int solIdx = 0; solIdx < nSol; ++solIdx)
+  {
+    if (_pBackend->getObjValue(solIdx) == obj_value)
+    {
+      MaxSolution::Triple sol;
+      _pBackend->getValues(solIdx, values);
+//      printVariables(solIdx, values, std::cout);
+      processSolution(values, sol);
+      
+      if (!solution.present(sol))
+      {
+        solution.add(sol);
+      }
+    }
+  }
+  
+  std::cerr << "[" << _pBackend->getObjValue() << ", " << _pBackend->getBestObjValue() << "]" << std::endl;
+  
+  return true;
+}
+  
+void IntMaxIlpSolver::addNoGood(const StlIntVector& parent)
+{
+  const Digraph& G = _G.getG();
+  const int n = _F_interval_clustered.getNrCols();
+  
+  MilpRow row;
+  for (int j = 0; j < n; ++j)
+  {
+    if (parent[j] == -1)
+    {
+      row.add(_x[_nodeToRootArcIndex[_indexToNode[j]]], 1);
+    }
+    else if (parent[j] >= 0)
+    {
+      Arc a = lemon::findArc(G, _indexToNode[parent[j]], _indexToNode[j]);
+      assert(a != lemon::INVALID);
+      row.add(_x[_arcToIndex[a]], 1);
+    }
+  }
+  
+  _model.addRow(row, -MilpModel::infinity(), row.size() - 1);
+  addFamily("no-good");
+  if (_loaded)
+  {
+    _pBackend->addRow(row, -MilpModel::infinity(), row.size() - 1);
+  }
+}
+  
+void IntMaxIlpSolver::addSizeBound(int size)
+{
+  MilpRow row;
+  for (int i = 0; i < _nodeCount + _arcCount; ++i)
+  {
+    row.add(_x[i], 1);
+  }
+  
+  _model.addRow(row, -MilpModel::infinity(), size);
+  addFamily("size bound");
+  if (_loaded)
+  {
+    _pBackend->addRow(row, -MilpModel::infinity(), size);
+  }
+}
+  
+int IntMaxIlpSolver::enumerate(int limit,
+                               const std::string& checkpoint,
+                               std::ostream& out)
+{
+  typedef std::set<StlIntVector> TreeSet;
+  
+  const int n = _F_interval_clustered.getNrCols();
+  
+  lemon::Timer timer;
+  load();
+  _exhausted = false;
+  
+  // a checkpoint consists of n and the optimal objective value followed by
+  // the parent vector of every tree found so far
+  TreeSet found;
+  double optObjValue = 0;
+  bool resumed = false;
+  if (checkpoint != "")
+  {
+    std::ifstream in(checkpoint.c_str());
+    int nn = -1;
+    if (in.good() && in >> nn >> optObjValue)
+    {
+      if (nn != n)
+      {
+        std::cerr << "Error: checkpoint '" << checkpoint << "' is for a graph with "
+                  << nn << " vertices rather than " << n << std::endl;
+        return -1;
+      }
+      resumed = true;
+      
+      StlIntVector parent(n);
+      while (true)
+      {
+        for (int j = 0; j < n && in; ++j)
+        {
+          in >> parent[j];
+        }
+        if (!in)
+        {
+          break;
+        }
+        if (found.insert(parent).second)
+        {
+          addNoGood(parent);
+        }
+      }
+      std::cerr << "Resuming from " << found.size() << " trees" << std::endl;
+    }
+  }
+  
+  std::ofstream checkpointOut;
+  if (checkpoint != "")
+  {
+    checkpointOut.open(checkpoint.c_str(), resumed ? std::ios::app : std::ios::out);
+    if (!checkpointOut.good())
+    {
+      std::cerr << "Error: failed to open '" << checkpoint << "' for writing" << std::endl;
+      return -1;
+    }
+    checkpointOut.precision(17);
+  }
+  
+  int nrWritten = 0;
+  StlDoubleVector values;
+  while (limit < 0 || nrWritten < limit)
+  {
+    int timeLimit = _timeLimit;
+    if (_timeLimit > 0)
+    {
+      timeLimit = _timeLimit - static_cast<int>(timer.realTime());
+      if (timeLimit <= 0)
+      {
+        break;
+      }
+    }
+    
+    // unless the time limit was hit, a failed solve means that the
+    // remaining model is infeasible
+    bool solved = optimize(timeLimit);
+    bool timeUp = _timeLimit > 0 && timer.realTime() >= _timeLimit;
+    if (!solved)
+    {
+      _exhausted = !timeUp;
+      break;
+    }
+    
+    if (!resumed && found.empty())
+    {
+      if (timeUp)
+      {
+        std::cerr << "Error: optimality was not proven within the time limit" << std::endl;
+        return -1;
+      }
+      optObjValue = _pBackend->getObjValue();
+      if (checkpoint != "")
+      {
+        checkpointOut << n << " " << optObjValue << std::endl;
+      }
+    }
+    
+    if (g_tol.less(_pBackend->getBestObjValue(), optObjValue))
+    {
+      // no remaining tree attains the optimum
+      _exhausted = true;
+      break;
+    }
+    
+    // besides the incumbent, the pool may hold other optimal trees
+    int nrNew = 0;
+    const int nSol = _pBackend->getNrSolutions();
+    for (int solIdx = 0; solIdx < nSol && (limit < 0 || nrWritten < limit); ++solIdx)
+    {
+      if (g_tol.less(_pBackend->getObjValue(solIdx), optObjValue))
+      {
+        continue;
+      }
+      
+      StlIntVector parent;
+      _pBackend->getValues(solIdx, values);
+      extractTree(values, parent);
+      if (!found.insert(parent).second)
+      {
+        continue;
+      }
+      addNoGood(parent);
+      ++nrNew;
+      
+      MaxSolution::Triple sol;
+      processSolution(values, sol);
+      MaxSolution single(_F_point_unclustered);
+      single.add(sol);
+      out << single << std::flush;
+      ++nrWritten;
+      
+      if (checkpoint != "")
+      {
+        for (int j = 0; j < n; ++j)
+        {
+          checkpointOut << (j == 0 ? "" : " ") << parent[j];
+        }
+        checkpointOut << std::endl;
+      }
+    }
+    
+    if (nrNew == 0)
+    {
+      // the incumbent does not attain the optimum, the bound only does
+      // within the optimality gap of the backend
+      _exhausted = !timeUp;
+      break;
+    }
+    std::cerr << "Trees: " << found.size() << std::endl;
+  }
+  
+  std::cerr << "[" << optObjValue << ", " << (_exhausted ? "exhausted" : "stopped")
+            << ", " << found.size() << " trees]" << std::endl;
+  if (_pTelemetryWriter)
+  {
+    std::ostringstream fields;
+    fields << "\"objective\": " << optObjValue
+           << ", \"trees\": " << found.size()
+           << ", \"exhausted\": " << (_exhausted ? "true" : "false");
+    _pTelemetryWriter->write("enumeration", fields.str());
+  }
+  
+  return nrWritten;
+}
+  
+double IntMaxIlpSolver::solveRelaxation()
+{
+  load();
+  
+  return _pBackend->solveRelaxation();
+}
+  
+void IntMaxIlpSolver::setIncumbentOutput(const std::string& filename)
+{
+  assert(!_loaded);
+  
+  delete _pIncumbentWriter;
+  _pIncumbentWriter = new IncumbentWriter(*this, filename);
+}
+  
+bool IntMaxIlpSolver::setTelemetryOutput(const std::string& filename,
+                                         double interval)
 {
-  assert(_G.isDAG());
-  assert(F_interval_clustered.getNrRows() == F_point_unclustered.getNrRows());
-  assert(F_interval_clustered.getNrCols() <= F_point_unclustered.getNrCols());
+  assert(!_loaded);
   
-  initVariables();
-  initConstraints();
-  initObjective();
+  delete _pTelemetryWriter;
+  _pTelemetryWriter = new TelemetryWriter(filename, interval);
+  if (!_pTelemetryWriter->good())
+  {
+    delete _pTelemetryWriter;
+    _pTelemetryWriter = NULL;
+    return false;
+  }
+  
+  return true;
 }
   
-IntMaxIlpSolver::~IntMaxIlpSolver()
+void IntMaxIlpSolver::addFamily(const std::string& name)
 {
-  _env.end();
+  if (!_familyName.empty() && _familyName.back() == name)
+  {
+    _familyEnd.back() = _model.getNrRows();
+  }
+  else
+  {
+    _familyName.push_back(name);
+    _familyEnd.push_back(_model.getNrRows());
+  }
 }
   
-bool IntMaxIlpSolver::solve(MaxSolution& solution)
+void IntMaxIlpSolver::writeModelTelemetry() const
 {
-  _cplex.setOut(std::cerr);
-  _cplex.setWarning(std::cerr);
-  _cplex.setError(std::cerr);
+  const int m = _F_interval_clustered.getNrRows();
+  
+  int nrFx = 0;
+  int nrG = 0;
+  for (int i = 0; i < m; ++i)
+  {
+    nrFx += _fx[i].size();
+    nrG += _g[i].size();
+  }
+  
+  std::ostringstream fields;
+  fields << "\"backend\": \"" << _pBackend->getName() << "\""
+         << ", \"formulation\": \"" << (_formulation == PRODUCT_FORMULATION ? "product" : "flow") << "\""
+         << ", \"samples\": " << m
+         << ", \"vertices\": " << _nodeCount
+         << ", \"arcs\": " << _arcCount
+         << ", \"variables\": " << _model.getNrCols()
+         << ", \"rows\": " << _model.getNrRows()
+         << ", \"nonzeros\": " << _model.getNrNonZeros()
+         << ", \"lazy_rows\": " << _model.getNrLazyRows()
+         << ", \"columns\": {\"x\": " << _x.size()
+         << ", \"f\": " << m * _F_interval_clustered.getNrCols()
+         << ", \"fx\": " << nrFx
+         << ", \"g\": " << nrG << "}"
+         << ", \"families\": [";
+  
+  // rows added after the last family are reported as other
+  int start = 0;
+  for (size_t f = 0; f <= _familyName.size(); ++f)
+  {
+    int end = f < _familyName.size() ? _familyEnd[f] : _model.getNrRows();
+    if (f == _familyName.size() && end == start)
+    {
+      break;
+    }
+    
+    fields << (f == 0 ? "" : ", ")
+           << "{\"name\": \"" << (f < _familyName.size() ? _familyName[f] : "other") << "\""
+           << ", \"rows\": " << end - start
+           << ", \"nonzeros\": " << _model.getRowStart(end) - _model.getRowStart(start) << "}";
+    start = end;
+  }
+  fields << "]";
+  _pTelemetryWriter->write("model", fields.str());
   
-  _cplex.setParam(IloCplex::SolnPoolAGap, 0.0);
-  _cplex.setParam(IloCplex::SolnPoolIntensity, 4);
-  _cplex.setParam(IloCplex::PopulateLim, 20000);
+  fields.str("");
+  fields << "\"fixed_roots\": " << _nrFixedRoots
+         << ", \"tightened_products\": " << _nrTightenedProducts;
+  _pTelemetryWriter->write("presolve", fields.str());
+}
   
-  if (_timeLimit > 0)
+void IntMaxIlpSolver::writeResultTelemetry(bool solved) const
+{
+  std::ostringstream fields;
+  fields << "\"solved\": " << (solved ? "true" : "false");
+  if (solved)
   {
-    _cplex.setParam(IloCplex::TiLim, _timeLimit);
+    double objValue = _pBackend->getObjValue();
+    double bound = _pBackend->getBestObjValue();
+    fields << ", \"objective\": ";
+    writeJsonNumber(fields, objValue);
+    fields << ", \"bound\": ";
+    writeJsonNumber(fields, bound);
+    fields << ", \"gap\": ";
+    writeJsonNumber(fields, relativeGap(objValue, bound));
+    fields << ", \"solutions\": " << _pBackend->getNrSolutions();
   }
+  _pTelemetryWriter->write("result", fields.str());
+}
   
-  if (!_cplex.solve())
+bool IntMaxIlpSolver::writeMPS(const std::string& filename) const
+{
+  std::ofstream out(filename.c_str());
+  if (!out.good())
   {
     return false;
   }
   
-  double obj_value = _cplex.getObjValue();
+  _model.writeMPS(out, "ancestree");
+  out.close();
   
-  int nSol = _cplex.getSolnPoolNsolns();
-  solution.clear();
+  return true;
+}
   
-  for (int solIdx = 0; solIdx < nSol; ++solIdx)
+void IntMaxIlpSolver::applyPresolve(const StlBoolVector& rootCandidate,
+                                    const RealIntervalMatrix& F_interval_nonroot)
+{
+  const Digraph& G = _G.getG();
+  const int m = _F_interval_clustered.getNrRows();
+  const int n = _F_interval_clustered.getNrCols();
+  
+  for (NodeIt v(G); v != lemon::INVALID; ++v)
   {
-    if (_cplex.getObjValue(solIdx) == obj_value)
+    if (!rootCandidate[_nodeToIndex[v]])
     {
-      MaxSolution::Triple sol;
-//      printVariables(solIdx, std::cout);
-      processSolution(solIdx, sol);
-      
-      if (!solution.present(sol))
+      setColBounds(_x[_nodeToRootArcIndex[v]], 0, 0);
+      ++_nrFixedRoots;
+    }
+  }
+  
+  // the product of an arc entering v_j is non-zero only if v_j is a non-root node
+  for (int i = 0; i < m; ++i)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      double ub = F_interval_nonroot(i, j).second;
+      for (int p = _fxOffset[j]; p < _fxOffset[j + 1]; ++p)
       {
-        solution.add(sol);
+        if (_fxToArcIndex[p] >= _nodeCount && ub < _model.getColUB(_fx[i][p]))
+        {
+          setColBounds(_fx[i][p], 0, ub);
+          ++_nrTightenedProducts;
+        }
       }
     }
   }
-  
-  std::cerr << "[" << _cplex.getObjValue() << ", " << _cplex.getBestObjValue() << "]" << std::endl;
-  
-  return true;
 }
   
-void IntMaxIlpSolver::printVariables(int solIdx, std::ostream& out) const
+void IntMaxIlpSolver::update(const BaseAncestryGraph& H)
 {
-  out << "Solution " << solIdx << std::endl;
-  out << "Obj value: " << _cplex.getObjValue(solIdx) << std::endl;
+  assert(_formulation == PRODUCT_FORMULATION);
+  assert(!_pCoverCutSeparator);
   
-  for (int i = 0; i < _arcCount + _nodeCount; ++i)
+  const Digraph& G = _G.getG();
+  const Digraph& HH = H.getG();
+  const int m = _F_interval_clustered.getNrRows();
+  const int n = _F_interval_clustered.getNrCols();
+  
+  StlBoolMatrix enabled(n, StlBoolVector(n, false));
+  for (ArcIt a(HH); a != lemon::INVALID; ++a)
   {
-    bool val = !(fabs(_cplex.getValue(_x[i], solIdx)) <= 1e-3);
-    if (val)
-      out << _x[i].getName() << " = " << val << std::endl;
+    enabled[H.mapNodeToColumn(HH.source(a))][H.mapNodeToColumn(HH.target(a))] = true;
+  }
+  
+  for (NodeIt v(G); v != lemon::INVALID; ++v)
+  {
+    setColBounds(_x[_nodeToRootArcIndex[v]], 0, 1);
+  }
+  for (ArcIt a(G); a != lemon::INVALID; ++a)
+  {
+    bool arc = enabled[_nodeToIndex[G.source(a)]][_nodeToIndex[G.target(a)]];
+    setColBounds(_x[_arcToIndex[a]], 0, arc ? 1 : 0);
   }
   
-  const int m = _F_interval_clustered.getNrRows();
-  const int n = _F_interval_clustered.getNrCols();
   for (int i = 0; i < m; ++i)
   {
     for (int j = 0; j < n; ++j)
     {
-      out << _f[i][j].getName() << " = " << _cplex.getValue(_f[i][j], solIdx) << std::endl;
+      const RealInterval& interval = _F_interval_clustered(i, j);
+      double ub = std::min(0.5, interval.second);
+      setColBounds(_f[i][j], std::min(interval.first, ub), ub);
+      for (int p = _fxOffset[j]; p < _fxOffset[j + 1]; ++p)
+      {
+        setColBounds(_fx[i][p], 0, ub);
+      }
     }
   }
+  
+  excludeAboveHalf();
+  
+  // a start for the previous bounds may be infeasible
+  _mipStart.clear();
+  _nrFixedRoots = 0;
+  _nrTightenedProducts = 0;
+}
+  
+void IntMaxIlpSolver::setColBounds(int col, double lb, double ub)
+{
+  _model.setColLB(col, lb);
+  _model.setColUB(col, ub);
+  if (_loaded)
+  {
+    _pBackend->setColBounds(col, lb, ub);
+  }
 }
   
-void IntMaxIlpSolver::processSolution(int solIdx, MaxSolution::Triple& sol) const
-{ 
+void IntMaxIlpSolver::excludeAboveHalf()
+{
   const Digraph& G = _G.getG();
+  const int m = _F_interval_clustered.getNrRows();
+  const int n = _F_interval_clustered.getNrCols();
   
-  // get arborescence from the solution
-  StlIntVector mutationSolVec;
-  IntNodeMap mutationSolMap(G, -1);
-  BoolNodeMap mutationSolMap2(G, false);
-  
-  // find root
-  for (NodeIt v(G); v != lemon::INVALID; ++v)
+  for (int j = 0; j < n; ++j)
   {
-    bool val = !(fabs(_cplex.getValue(_x[_nodeToRootArcIndex[v]], solIdx)) <= 1e-3);
-    if (val)
+    bool aboveHalf = false;
+    for (int i = 0; i < m && !aboveHalf; ++i)
+    {
+      aboveHalf = _F_interval_clustered(i, j).first > 0.5;
+    }
+    if (!aboveHalf)
     {
-      mutationSolMap[v] = mutationSolVec.size();
-      mutationSolVec.push_back(_nodeToIndex[v]);
-      mutationSolMap2[v] = true;
+      continue;
+    }
+    
+    Node v_j = _indexToNode[j];
+    setColBounds(_x[_nodeToRootArcIndex[v_j]], 0, 0);
+    for (InArcIt a(G, v_j); a != lemon::INVALID; ++a)
+    {
+      setColBounds(_x[_arcToIndex[a]], 0, 0);
     }
   }
+}
+  
+int IntMaxIlpSolver::addCoverCuts()
+{
+  assert(!_loaded);
+  
+  const Digraph& G = _G.getG();
+  const int m = _F_interval_clustered.getNrRows();
+  const int n = _F_interval_clustered.getNrCols();
   
-  BoolArcMap arcSolMap(G, false);
+  _outArcIndex = StlIntMatrix(n);
+  _outArcTarget = StlIntMatrix(n);
   for (ArcIt a(G); a != lemon::INVALID; ++a)
   {
-    bool val = !(fabs(_cplex.getValue(_x[_arcToIndex[a]], solIdx)) <= 1e-3);
-    arcSolMap[a] = val;
+    int j = _nodeToIndex[G.source(a)];
+    _outArcIndex[j].push_back(_arcToIndex[a]);
+    _outArcTarget[j].push_back(_nodeToIndex[G.target(a)]);
+  }
+  
+  // covers of size one and two are added upfront
+  int res = 0;
+  MilpRow row;
+  for (int j = 0; j < n; ++j)
+  {
+    const StlIntVector& arcs = _outArcIndex[j];
+    const StlIntVector& targets = _outArcTarget[j];
+    const int d = arcs.size();
     
-    if (val)
+    StlBoolVector single(d, false);
+    for (int t = 0; t < d; ++t)
     {
-      Node u = G.source(a);
-      if (mutationSolMap[u] == -1)
+      for (int i = 0; i < m && !single[t]; ++i)
+      {
+        single[t] = g_tol.less(std::min(0.5, _F_interval_clustered(i, j).second),
+                               _F_interval_clustered(i, targets[t]).first);
+      }
+      if (single[t])
       {
-        mutationSolMap[u] = mutationSolVec.size();
-        mutationSolVec.push_back(_nodeToIndex[u]);
-        mutationSolMap2[u] = true;
+        row.clear();
+        row.add(_x[arcs[t]], 1);
+        _model.addRow(row, -MilpModel::infinity(), 0);
+        ++res;
       }
+    }
+    
+    for (int t1 = 0; t1 < d; ++t1)
+    {
+      if (single[t1])
+        continue;
       
-      Node v = G.target(a);
-      if (mutationSolMap[v] == -1)
+      for (int t2 = t1 + 1; t2 < d; ++t2)
       {
-        mutationSolMap[v] = mutationSolVec.size();
-        mutationSolVec.push_back(_nodeToIndex[v]);
-        mutationSolMap2[v] = true;
+        if (single[t2])
+          continue;
+        
+        for (int i = 0; i < m; ++i)
+        {
+          if (g_tol.less(std::min(0.5, _F_interval_clustered(i, j).second),
+                         _F_interval_clustered(i, targets[t1]).first
+                         + _F_interval_clustered(i, targets[t2]).first))
+          {
+            row.clear();
+            row.add(_x[arcs[t1]], 1);
+            row.add(_x[arcs[t2]], 1);
+            _model.addRow(row, -MilpModel::infinity(), 1);
+            ++res;
+            break;
+          }
+        }
       }
     }
   }
   
+  addFamily("cover");
+  
+  // larger covers are separated by backends that support it
+  delete _pCoverCutSeparator;
+  _pCoverCutSeparator = new CoverCutSeparator(_x,
+                                              _outArcIndex,
+                                              _outArcTarget,
+                                              _F_interval_clustered);
+  
+  return res;
+}
+  
+void IntMaxIlpSolver::printVariables(int solIdx,
+                                     const StlDoubleVector& values,
+                                     std::ostream& out) const
+{
+  out << "Solution " << solIdx << std::endl;
+  out << "Obj value: " << _pBackend->getObjValue(solIdx) << std::endl;
+  
+  for (int i = 0; i < _arcCount + _nodeCount; ++i)
+  {
+    bool val = !(fabs(values[_x[i]]) <= 1e-3);
+    if (val)
+      out << _model.getColName(_x[i]) << " = " << val << std::endl;
+  }
+  
   const int m = _F_interval_clustered.getNrRows();
-  const int n = mutationSolVec.size();
+  const int n = _F_interval_clustered.getNrCols();
+  for (int i = 0; i < m; ++i)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      out << _model.getColName(_f[i][j]) << " = " << values[_f[i][j]] << std::endl;
+    }
+  }
+}
   
-  typedef lemon::SubDigraph<const Digraph> SubDigraph;
-  SubDigraph subG(_G.getG(), mutationSolMap2, arcSolMap);
+void IntMaxIlpSolver::extractTree(const StlDoubleVector& values,
+                                  StlIntVector& parent) const
+{
+  const Digraph& G = _G.getG();
+  const int n = _F_interval_clustered.getNrCols();
   
-  for (SubDigraph::NodeIt v_j(subG); v_j != lemon::INVALID; ++v_j)
+  parent = StlIntVector(n, -2);
+  for (NodeIt v(G); v != lemon::INVALID; ++v)
   {
-    int j = _nodeToIndex[v_j];
-    for (int i = 0; i < m; ++i)
+    bool val = !(fabs(values[_x[_nodeToRootArcIndex[v]]]) <= 1e-3);
+    if (val)
     {
-      const RealInterval& interval_ij = _F_interval_clustered(i,j);
-      double f_ij = _cplex.getValue(_f[i][j]);
-      assert(!g_tol.less(f_ij, interval_ij.first) && !g_tol.less(interval_ij.second, f_ij));
-      double sum = 0;
-      for (SubDigraph::OutArcIt a_jk(subG, v_j); a_jk != lemon::INVALID; ++a_jk)
-      {
-        Node v_k = G.target(a_jk);
-        int k = _nodeToIndex[v_k];
-        double f_ik = _cplex.getValue(_f[i][k]);
-        const RealInterval& interval = _F_interval_clustered(i,k);
-        assert(!g_tol.less(f_ik, interval.first) && !g_tol.less(interval.second, f_ik));
-        sum += f_ik;
-      }
-      assert(!g_tol.less(f_ij, sum));
+      parent[_nodeToIndex[v]] = -1;
     }
   }
   
-  sol._T = ClonalTree(subG, mutationSolMap, _G.getProbMap());
-
-  sol._F = RealMatrix(m, n);
-  for (int i = 0; i < m; ++i)
+  for (ArcIt a(G); a != lemon::INVALID; ++a)
   {
-    sol._F.setRowLabel(i, _F_point_unclustered.getRowLabel(i));
-    for (int j = 0; j < n; ++j)
+    bool val = !(fabs(values[_x[_arcToIndex[a]]]) <= 1e-3);
+    if (val)
     {
-      double f_ij = _cplex.getValue(_f[i][mutationSolVec[j]], solIdx);
-      if (!g_tol.nonZero(f_ij))
-      {
-        f_ij = 0;
-      }
-      sol._F.set(i, j, f_ij);
+      parent[_nodeToIndex[G.target(a)]] = _nodeToIndex[G.source(a)];
     }
   }
+}
   
-  char buf[1024];
-  for (int j = 0; j < n; ++j)
+void IntMaxIlpSolver::processSolution(const StlDoubleVector& values,
+                                      MaxSolution::Triple& sol) const
+{ 
+  const int m = _F_interval_clustered.getNrRows();
+  const int n = _F_interval_clustered.getNrCols();
+  
+  // get arborescence from the solution
+  StlIntVector parent;
+  extractTree(values, parent);
+  
+  StlDoubleMatrix f(m, StlDoubleVector(n, 0));
+  for (int i = 0; i < m; ++i)
   {
-    const StlIntVector& M = _toUnclusteredColumn[mutationSolVec[j]];
-    std::string label;
-    bool first = true;
-    for (StlIntVectorIt it = M.begin(); it != M.end(); ++it)
+    for (int j = 0; j < n; ++j)
     {
-      if (first)
-      {
-        first = false;
-      }
-      else
+      if (parent[j] != -2)
       {
-        label += ";";
+        f[i][j] = values[_f[i][j]];
       }
-      snprintf(buf, 1024, "%d", *it);
-      label += buf;
     }
-    
-    sol._F.setColLabel(j, label);
   }
   
-  sol._U = sol._T.getU(sol._F);
+  constructSolution(parent, f, sol);
 }
   
 void IntMaxIlpSolver::initVariables()
@@ -245,20 +1311,17 @@ void IntMaxIlpSolver::initVariables()
   
   const Digraph& G = _G.getG();
   
-#ifdef DEBUG
-  char buf[1024];
-#endif
+  // columns are only named in debug mode, the model names them C<index> otherwise
+  char buf[1024] = "";
   
-  _x = IloBoolVarArray(_env, _arcCount + _nodeCount);
+  _x = StlIntVector(_arcCount + _nodeCount, -1);
   int i = 0;
   for (NodeIt v(G); v != lemon::INVALID; ++v, ++i)
   {
 #ifdef DEBUG
     snprintf(buf, 1024, "x_r_%d", i);
-    _x[i] = IloBoolVar(_env, buf);
-#else
-    _x[i] = IloBoolVar(_env);
 #endif
+    _x[i] = _model.addCol(0, 1, 0, MilpModel::BINARY, buf);
     _nodeToRootArcIndex[v] = i;
   }
   
@@ -271,33 +1334,58 @@ void IntMaxIlpSolver::initVariables()
     snprintf(buf, 1024, "x_%d_%d",
              _nodeToIndex[G.source(a)],
              _nodeToIndex[G.target(a)]);
-    _x[i] = IloBoolVar(_env, buf);
-#else
-    _x[i] = IloBoolVar(_env);
 #endif
+    _x[i] = _model.addCol(0, 1, 0, MilpModel::BINARY, buf);
+  }
+  
+  // fx[i][p] is only needed for the product f[i][j] * x[kl] where kl is
+  // the root arc of v_j or an arc entering v_j (CSR layout, row j of the
+  // map spans [_fxOffset[j], _fxOffset[j+1]))
+  _fxOffset = StlIntVector(n + 1, 0);
+  _fxToArcIndex.clear();
+  _fxToArcIndex.reserve(_nodeCount + _arcCount);
+  _arcIndexToFx = StlIntVector(_nodeCount + _arcCount, -1);
+  for (int j = 0; j < n; ++j)
+  {
+    Node v_j = _indexToNode[j];
+    _fxOffset[j] = _fxToArcIndex.size();
+    
+    if (_formulation == PRODUCT_FORMULATION)
+    {
+      int kl = _nodeToRootArcIndex[v_j];
+      _arcIndexToFx[kl] = _fxToArcIndex.size();
+      _fxToArcIndex.push_back(kl);
+    }
+    
+    for (InArcIt a(G, v_j); a != lemon::INVALID; ++a)
+    {
+      int kl = _arcToIndex[a];
+      _arcIndexToFx[kl] = _fxToArcIndex.size();
+      _fxToArcIndex.push_back(kl);
+    }
   }
+  _fxOffset[n] = _fxToArcIndex.size();
   
-  _f = IloNumVarMatrix(_env, m);
-  _fx = IloNumVar3Matrix(_env, m);
+  _f = StlIntMatrix(m, StlIntVector(n, -1));
+  _fx = StlIntMatrix(m, StlIntVector(_fxOffset[n], -1));
   for (int i = 0; i < m; ++i)
   {
-    _f[i] = IloNumVarArray(_env, n, 0, 0.5);
-    _fx[i] = IloNumVarMatrix(_env, n);
     for (int j = 0; j < n; ++j)
     {
       const RealInterval& interval = _F_interval_clustered(i, j);
 #ifdef DEBUG
       snprintf(buf, 1024, "f_%d_%d", i, j);
-      _f[i][j].setName(buf);
 #endif
-      _f[i][j].setLB(interval.first);
-      _f[i][j].setUB(interval.second);
+      // f <= 0.5 is implied by fx <= 0.5 for tree nodes in the product
+      // formulation, the flow formulation has no product for the root
+      double ub = std::min(0.5, interval.second);
+      _f[i][j] = _model.addCol(std::min(interval.first, ub), ub,
+                               0, MilpModel::CONTINUOUS, buf);
       
-      _fx[i][j] = IloNumVarArray(_env, _nodeCount + _arcCount, 0, 0.5);
-#ifdef DEBUG
-      for (int k = 0; k < _nodeCount + _arcCount; ++k)
+      for (int p = _fxOffset[j]; p < _fxOffset[j + 1]; ++p)
       {
-        Arc a = _indexToArc[k];
+#ifdef DEBUG
+        Arc a = _indexToArc[_fxToArcIndex[p]];
         if (a != lemon::INVALID)
         {
           Node u = G.source(a);
@@ -306,32 +1394,33 @@ void IntMaxIlpSolver::initVariables()
           snprintf(buf, 1024, "fx_%d_%d_(%d_%d)",
                    i, j,
                    _nodeToIndex[u], _nodeToIndex[v]);
-          _fx[i][j][k].setName(buf);
         }
         else
         {
           snprintf(buf, 1024, "fx_%d_%d_(r_%d)",
-                   i, j, k);
-          _fx[i][j][k].setName(buf);
+                   i, j, _fxToArcIndex[p]);
         }
-      }
 #endif
+        _fx[i][p] = _model.addCol(0, std::min(0.5, interval.second),
+                                  0, MilpModel::CONTINUOUS, buf);
+      }
     }
   }
   
-  _g = IloNumVarMatrix(_env, m);
   int org_n = _F_point_unclustered.getNrCols();
+  _g = StlIntMatrix(m, StlIntVector(org_n, -1));
   for (int i = 0; i < m; ++i)
   {
-    _g[i] = IloNumVarArray(_env, org_n, 0, 0.5);
-#ifdef DEBUG
     for (int j = 0; j < org_n; ++j)
     {
+#ifdef DEBUG
       snprintf(buf, 1024, "g_%d_%d", i, j);
-      _g[i][j].setName(buf);
-    }
 #endif
+      _g[i][j] = _model.addCol(0, 0.5, 0, MilpModel::CONTINUOUS, buf);
+    }
   }
+  
+  excludeAboveHalf();
 }
   
 void IntMaxIlpSolver::initConstraints()
@@ -339,137 +1428,211 @@ void IntMaxIlpSolver::initConstraints()
   const Digraph& G = _G.getG();
   const int m = _F_interval_clustered.getNrRows();
   const int n = _F_interval_clustered.getNrCols();
+  const double inf = MilpModel::infinity();
   
-  IloExpr sum(_env);
+  MilpRow row;
   
   // arborescence
   for (ArcIt jk(G); jk != lemon::INVALID; ++jk)
   {
     Node j = G.source(jk);
-    sum += _x[_nodeToRootArcIndex[j]];
+    row.add(_x[_nodeToRootArcIndex[j]], 1);
     for (InArcIt ij(G, j); ij != lemon::INVALID; ++ij)
     {
-      sum += _x[_arcToIndex[ij]];
+      row.add(_x[_arcToIndex[ij]], 1);
     }
+    row.add(_x[_arcToIndex[jk]], -1);
     
-    _model.add(sum >= _x[_arcToIndex[jk]]);
-    sum.clear();
+    _model.addRow(row, 0, inf);
+    row.clear();
   }
+  addFamily("arborescence");
   
   // at most one incoming arc per node
   for (NodeIt v(G); v != lemon::INVALID; ++v)
   {
     for (InArcIt a(G, v); a != lemon::INVALID; ++a)
     {
-      sum += _x[_arcToIndex[a]];
+      row.add(_x[_arcToIndex[a]], 1);
     }
-    _model.add(sum <= 1);
-    sum.clear();
+    _model.addRow(row, -inf, 1);
+    row.clear();
   }
+  addFamily("indegree");
   
   // there is exactly one root
   for (NodeIt v(G); v != lemon::INVALID; ++v)
   {
-    sum += _x[_nodeToRootArcIndex[v]];
+    row.add(_x[_nodeToRootArcIndex[v]], 1);
+  }
+  _model.addRow(row, 1, 1);
+  row.clear();
+  addFamily("root");
+  
+  _sampleRows = StlIntMatrix(m);
+  if (_formulation == PRODUCT_FORMULATION)
+  {
+    initProductConstraints();
+  }
+  else
+  {
+    initFlowConstraints();
+  }
+  
+  // VAF deviation
+  for (int i = 0; i < m; ++i)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      const StlIntVector& M = _toUnclusteredColumn[j];
+      for (StlIntVectorIt it = M.begin(); it != M.end(); ++it)
+      {
+        // we need to truncate the point estimate f at 0.5 because g <= 0.5
+        double f = std::min(0.5, _F_point_unclustered(i, *it));
+        
+        // g >= f - f[i][j]
+        row.add(_g[i][*it], 1);
+        row.add(_f[i][j], 1);
+        _model.addRow(row, f, inf);
+        row.clear();
+        
+        // g >= f[i][j] - f
+        row.add(_g[i][*it], 1);
+        row.add(_f[i][j], -1);
+        _model.addRow(row, -f, inf);
+        row.clear();
+      }
+    }
   }
-  _model.add(sum == 1);
-  sum.clear();
+  addFamily("deviation");
+}
+  
+void IntMaxIlpSolver::initProductConstraints()
+{
+  const Digraph& G = _G.getG();
+  const int m = _F_interval_clustered.getNrRows();
+  const int n = _F_interval_clustered.getNrCols();
+  const double inf = MilpModel::infinity();
+  
+  MilpRow row;
   
   // product
   for (int i = 0; i < m; ++i)
   {
     for (int j = 0; j < n; ++j)
     {
-      Node v_j = _indexToNode[j];
-      for (int kl = 0; kl < _nodeCount + _arcCount; ++kl)
+      for (int p = _fxOffset[j]; p < _fxOffset[j + 1]; ++p)
       {
-        if (kl < _nodeCount)
-        {
-          // fake arc
-          if (kl != _nodeToRootArcIndex[v_j])
-          {
-            _model.add(_fx[i][j][kl] == 0);
-          }
-          else
-          {
-            _model.add(_fx[i][j][kl] <= _f[i][j]);
-            _model.add(_fx[i][j][kl] <= _x[kl]);
-            _model.add(_fx[i][j][kl] >= _f[i][j] + _x[kl] - 1);
-          }
-        }
-        else
-        {
-          Arc a = _indexToArc[kl];
-          assert(a != lemon::INVALID);
-          Node v_k = G.source(a);
-          Node v_l = G.target(a);
-          
-          if (v_k == v_j || v_l == v_j)
-          {
-            _model.add(_fx[i][j][kl] <= _f[i][j]);
-            _model.add(_fx[i][j][kl] <= _x[kl]);
-            _model.add(_fx[i][j][kl] >= _f[i][j] + _x[kl] - 1);
-          }
-          else
-          {
-            _model.add(_fx[i][j][kl] == 0);
-          }
-        }
+        int kl = _fxToArcIndex[p];
+        
+        // fx <= f[i][j]
+        row.add(_fx[i][p], 1);
+        row.add(_f[i][j], -1);
+        _sampleRows[i].push_back(_model.addRow(row, -inf, 0));
+        row.clear();
+        
+        // fx <= x[kl]
+        row.add(_fx[i][p], 1);
+        row.add(_x[kl], -1);
+        _sampleRows[i].push_back(_model.addRow(row, -inf, 0));
+        row.clear();
+        
+        // fx >= f[i][j] + x[kl] - 1
+        row.add(_fx[i][p], 1);
+        row.add(_f[i][j], -1);
+        row.add(_x[kl], -1);
+        _sampleRows[i].push_back(_model.addRow(row, -1, inf));
+        row.clear();
       }
     }
   }
+  addFamily("product");
   
   // sum rule constraint
   for (NodeIt v_k(G); v_k != lemon::INVALID; ++v_k)
   {
-    int k = _nodeToIndex[v_k];
     for (int i = 0; i < m; ++i)
     {
-      sum += _fx[i][k][_nodeToRootArcIndex[v_k]];
+      row.add(_fx[i][_arcIndexToFx[_nodeToRootArcIndex[v_k]]], 1);
       for (InArcIt a(G, v_k); a != lemon::INVALID; ++a)
       {
-//        Node v_j = G.source(a);
-//        int j = _nodeToIndex[v_j];
-        sum += _fx[i][k][_arcToIndex[a]];
+        row.add(_fx[i][_arcIndexToFx[_arcToIndex[a]]], 1);
       }
       for (OutArcIt a(G, v_k); a != lemon::INVALID; ++a)
       {
-        Node v_l = G.target(a);
-        int l = _nodeToIndex[v_l];
-        sum -= _fx[i][l][_arcToIndex[a]];
+        // fx of arc (k,l) is the product with f[i][l]
+        row.add(_fx[i][_arcIndexToFx[_arcToIndex[a]]], -1);
       }
       
-      _model.add(sum >= 0);
-      sum.clear();
+      _sampleRows[i].push_back(_model.addRow(row, 0, inf));
+      row.clear();
     }
   }
+  addFamily("sum rule");
+}
   
-  // VAF deviation
+void IntMaxIlpSolver::initFlowConstraints()
+{
+  const Digraph& G = _G.getG();
+  const int m = _F_interval_clustered.getNrRows();
+  const int n = _F_interval_clustered.getNrCols();
+  const double inf = MilpModel::infinity();
+  
+  MilpRow row;
+  
+  // flow along (k,l): fx = f[i][l] if x[(k,l)] = 1 and fx = 0 otherwise,
+  // linked by the upper bound of the confidence interval of f[i][l]
   for (int i = 0; i < m; ++i)
   {
     for (int j = 0; j < n; ++j)
     {
-      const StlIntVector& M = _toUnclusteredColumn[j];
-      for (StlIntVectorIt it = M.begin(); it != M.end(); ++it)
+      double ub = std::min(0.5, _F_interval_clustered(i, j).second);
+      for (int p = _fxOffset[j]; p < _fxOffset[j + 1]; ++p)
       {
-        // we need to truncate the point estimate f at 0.5 because g <= 0.5
-        double f = std::min(0.5, _F_point_unclustered(i, *it));
-        _model.add(_g[i][*it] >= f - _f[i][j]);
-        _model.add(_g[i][*it] >= _f[i][j] - f);
+        int kl = _fxToArcIndex[p];
+        
+        // fx <= ub * x[kl]
+        row.add(_fx[i][p], 1);
+        row.add(_x[kl], -ub);
+        _sampleRows[i].push_back(_model.addRow(row, -inf, 0));
+        row.clear();
+        
+        // fx >= f[i][j] - ub * (1 - x[kl])
+        row.add(_fx[i][p], 1);
+        row.add(_f[i][j], -1);
+        row.add(_x[kl], -ub);
+        _sampleRows[i].push_back(_model.addRow(row, -ub, inf));
+        row.clear();
       }
     }
   }
+  addFamily("flow");
   
-  sum.end();
+  // sum rule constraint: outgoing flow is bounded by f[i][k], nodes that
+  // are not in the tree have no outgoing arcs due to the arborescence rows
+  for (NodeIt v_k(G); v_k != lemon::INVALID; ++v_k)
+  {
+    int k = _nodeToIndex[v_k];
+    for (int i = 0; i < m; ++i)
+    {
+      for (OutArcIt a(G, v_k); a != lemon::INVALID; ++a)
+      {
+        row.add(_fx[i][_arcIndexToFx[_arcToIndex[a]]], 1);
+      }
+      row.add(_f[i][k], -1);
+      
+      _sampleRows[i].push_back(_model.addRow(row, -inf, 0));
+      row.clear();
+    }
+  }
+  addFamily("sum rule");
 }
   
 void IntMaxIlpSolver::initObjective()
 {
-  IloExpr sum(_env);
-  
   for (int i = 0; i < _nodeCount + _arcCount; ++i)
   {
-    sum += _x[i];
+    _model.setColObj(_x[i], 1);
   }
   
   const int m = _F_point_unclustered.getNrRows();
@@ -479,13 +1642,11 @@ void IntMaxIlpSolver::initObjective()
   {
     for (int j = 0; j < org_n; ++j)
     {
-      sum -= frac * _g[i][j];
+      _model.setColObj(_g[i][j], -frac);
     }
   }
   
-  _model.add(IloObjective(_env, sum, IloObjective::Maximize));
-  
-  sum.end();
+  _model.setMaximize(true);
 }
   
 }
\ No newline at end of file
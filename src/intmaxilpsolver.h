@@ -8,60 +8,186 @@
 #ifndef INTMAXILPSOLVER_H
 #define INTMAXILPSOLVER_H
 
-#include <ilcplex/ilocplex.h>
-#include "baseancestrygraph.h"
-#include "realintervalmatrix.h"
-#include "maxsolution.h"
+#include "solver.h"
+#include "milpmodel.h"
+#include "milpbackend.h"
 #include <vector>
 
 namespace vaff {
 
-class IntMaxIlpSolver
+class TelemetryWriter;
+
+class IntMaxIlpSolver : public Solver
 {
 public:
+  // linearization of the sum rule
+  enum Formulation
+  {
+    // McCormick rows for every product f[i][l] * x[(k,l)]
+    PRODUCT_FORMULATION,
+    // one flow variable per sample and arc linked to x by the CI bounds
+    FLOW_FORMULATION
+  };
+  
+  // backend must be one of MilpBackend::getAvailable(), empty selects the default
   IntMaxIlpSolver(const BaseAncestryGraph& G,
                   const RealIntervalMatrix& F_interval_clustered,
                   const RealMatrix& F_point_unclustered,
                   const StlIntMatrix& toUnclusteredColumn,
-                  int timeLimit);
+                  int timeLimit,
+                  Formulation formulation = PRODUCT_FORMULATION,
+                  const std::string& backend = "");
   
   ~IntMaxIlpSolver();
   
   bool solve(MaxSolution& solution);
   
-  void exportModel(const std::string& filename)
+  // enumerates the optimal trees, excluding each tree that is found by a
+  // no-good row on its arcs, and writes every tree to out as a single
+  // solution as soon as it is found; stops after limit trees (-1: no limit);
+  // unless checkpoint is empty, the trees are also appended to checkpoint,
+  // whose trees from a previous run are excluded but not written again;
+  // returns the number of trees written, -1 on failure
+  int enumerate(int limit,
+                const std::string& checkpoint,
+                std::ostream& out);
+  
+  // false if enumerate stopped before all optimal trees were found
+  bool isExhausted() const
+  {
+    return _exhausted;
+  }
+  
+  double solveRelaxation();
+  
+  void applyPresolve(const StlBoolVector& rootCandidate,
+                     const RealIntervalMatrix& F_interval_nonroot);
+  
+  // rereads the confidence intervals, which may have been changed in place,
+  // and restricts the arcs to those of H, a subgraph of G on the same
+  // columns; presolve bounds are reset and can be reapplied by applyPresolve;
+  // a loaded model is changed in place, so the backend keeps its state. Only
+  // for the product formulation without cover cuts, as the flow rows and the
+  // cover rows depend on the intervals
+  void update(const BaseAncestryGraph& H);
+  
+  int addCoverCuts();
+  
+  // adds the row sum_j y[j] <= size, where y[j] is the sum of the x columns
+  // of the arcs entering v_j including its root arc, for an upper bound on
+  // the number of vertices of a tree
+  void addSizeBound(int size);
+  
+  // installs the tree given by parent (as in computeFrequencies) as MIP
+  // start, returns false if it violates the sum rule or the presolve bounds
+  bool setMipStart(const StlIntVector& parent);
+  
+  // installs the part of the tree of sol that maps onto G as MIP start
+  bool setMipStart(const MaxSolution::Triple& sol);
+  
+  bool writeMPS(const std::string& filename) const;
+  
+  // while solving, every improving incumbent is written to filename as a
+  // single solution, the header line holds its objective value, the bound
+  // and the gap; the file is replaced atomically
+  void setIncumbentOutput(const std::string& filename);
+  
+  // writes JSON lines to filename: the model statistics per constraint
+  // family, the presolve reductions, the progress of the backend every
+  // interval seconds and the result; returns false if filename cannot be
+  // opened for writing
+  bool setTelemetryOutput(const std::string& filename, double interval);
+  
+  void setNrThreads(int nrThreads)
+  {
+    assert(!_loaded);
+    _nrThreads = nrThreads;
+  }
+  
+  // makes the sum rule rows of all but the nrSeedSamples samples with the
+  // widest VAF spread lazy, returns the number of lazy rows; backends without
+  // lazy rows are solved repeatedly, adding the rows of violated samples
+  int setLazySamples(int nrSeedSamples);
+  
+  std::string getBackendName() const
+  {
+    return _pBackend->getName();
+  }
+  
+  int getNrVariables() const
   {
-    _cplex.exportModel(filename.c_str());
+    return _model.getNrCols();
   }
   
+  int getNrConstraints() const
+  {
+    return _model.getNrRows();
+  }
+  
+  int getNrNonZeros() const
+  {
+    return _model.getNrNonZeros();
+  }
+  
+  double getObjValue() const
+  {
+    return _pBackend->getObjValue();
+  }
+  
+  double getBestObjValue() const
+  {
+    return _pBackend->getBestObjValue();
+  }
+
 protected:
-  typedef BaseAncestryGraph::Digraph Digraph;
-  DIGRAPH_TYPEDEFS(Digraph);
+  friend class IncumbentWriter;
   
   typedef std::vector<Arc> ArcVector;
   typedef std::vector<Node> NodeVector;
   
   void initVariables();
   void initConstraints();
+  void initProductConstraints();
+  void initFlowConstraints();
   void initObjective();
   
-  void printVariables(int solIdx, std::ostream& out) const;
+  void load();
+  
+  // changes the bounds of col in the model and, once loaded, in the backend
+  void setColBounds(int col, double lb, double ub);
+  
+  // f is capped at 0.5, so a cluster whose CI lower bound exceeds 0.5 in
+  // some sample cannot be a tree vertex: its root arc and in-arcs are fixed
+  // to 0, as fx <= 0.5 did before the cap
+  void excludeAboveHalf();
+  
+  // marks the rows added since the previous family as family name
+  void addFamily(const std::string& name);
+  
+  void writeModelTelemetry() const;
+  
+  void writeResultTelemetry(bool solved) const;
   
-  void processSolution(int solIdx, MaxSolution::Triple& sol) const;
+  // solves the loaded model, adding violated lazy rows if the backend does
+  // not support them
+  bool optimize(int timeLimit);
   
-  typedef IloArray<IloBoolVarArray> IloBoolVarMatrix;
-  typedef IloArray<IloBoolArray> IloBoolMatrix;
-  typedef IloArray<IloBoolVarMatrix> IloBoolVar3Matrix;
+  // excludes the tree given by parent (as in computeFrequencies): as no
+  // superset of an optimal tree is feasible, sum_{a in T} x[a] <= |T| - 1
+  // suffices
+  void addNoGood(const StlIntVector& parent);
   
-  typedef IloArray<IloNumVarArray> IloNumVarMatrix;
-  typedef IloArray<IloNumArray> IloNumMatrix;
-  typedef IloArray<IloNumVarMatrix> IloNumVar3Matrix;
+  // makes the rows of samples violated by the incumbent non-lazy and reloads
+  // the model, returns the number of such samples
+  int activateViolatedSamples();
   
-  const BaseAncestryGraph& _G;
-  const RealIntervalMatrix& _F_interval_clustered;
-  const RealMatrix& _F_point_unclustered;
-  const StlIntMatrix& _toUnclusteredColumn;
-  const int _timeLimit;
+  void printVariables(int solIdx, const StlDoubleVector& values, std::ostream& out) const;
+  
+  void extractTree(const StlDoubleVector& values, StlIntVector& parent) const;
+  
+  void processSolution(const StlDoubleVector& values, MaxSolution::Triple& sol) const;
+  
+  const Formulation _formulation;
   
   const int _nodeCount;
   const IntNodeMap& _nodeToIndex;
@@ -72,20 +198,51 @@ protected:
   IntArcMap _arcToIndex;
   ArcVector _indexToArc;
   
-  IloEnv _env;
-  IloModel _model;
-  IloCplex _cplex;
-  
-  // x[(j,k)] : arc (v_j,v_k) is in the solution
-  IloBoolVarArray _x;
-  // f[i][j] : corrected VAF for sample i and mutation j
-  IloNumVarMatrix _f;
-  // fx[i][j][(k,l)] = f[i][j] * x[(k,l)]
-  IloNumVar3Matrix _fx;
-  // f[i][j] : VAF deviation for sample i and unclustered mutation j
-  IloNumVarMatrix _g;
+  MilpModel _model;
+  MilpBackend* _pBackend;
+  MilpCutSeparator* _pCoverCutSeparator;
+  MilpIncumbentListener* _pIncumbentWriter;
+  TelemetryWriter* _pTelemetryWriter;
+  // the model is handed to the backend upon the first solve
+  bool _loaded;
+  // column values of the MIP start, empty if there is none
+  StlDoubleVector _mipStart;
+  // backend threads, 0 for the backend default
+  int _nrThreads;
+  bool _exhausted;
+  
+  // x[(j,k)] : column of arc (v_j,v_k) being in the solution
+  StlIntVector _x;
+  // f[i][j] : column of the corrected VAF for sample i and mutation j
+  StlIntMatrix _f;
+  // _fxOffset[j] : first product index of mutation j
+  StlIntVector _fxOffset;
+  // _fxToArcIndex[p] : x index of product p
+  StlIntVector _fxToArcIndex;
+  // _arcIndexToFx[(k,l)] : product index of f[i][l] * x[(k,l)]
+  StlIntVector _arcIndexToFx;
+  // fx[i][p] = f[i][j] * x[(k,l)] where (k,l) = _fxToArcIndex[p] enters v_j
+  // (flow formulation: root arcs have no product)
+  StlIntMatrix _fx;
+  // g[i][j] : column of the VAF deviation for sample i and unclustered mutation j
+  StlIntMatrix _g;
+  
+  // _sampleRows[i] : product (or flow) and sum rule rows of sample i
+  StlIntMatrix _sampleRows;
+  
+  // rows [_familyEnd[f-1], _familyEnd[f]) form constraint family _familyName[f]
+  std::vector<std::string> _familyName;
+  StlIntVector _familyEnd;
+  // presolve reductions
+  int _nrFixedRoots;
+  int _nrTightenedProducts;
+  
+  // _outArcIndex[j] : x indices of the arcs leaving v_j
+  StlIntMatrix _outArcIndex;
+  // _outArcTarget[j][t] : column of the target of arc _outArcIndex[j][t]
+  StlIntMatrix _outArcTarget;
 };
-  
+
 }
 
-#endif // MAXILPSOLVER_H
\ No newline at end of file
+#endif // MAXILPSOLVER_H
@@ -0,0 +1,208 @@
+/*
+ *  lagrangianbound.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "lagrangianbound.h"
+#include "solver.h"
+
+namespace vaff {
+
+LagrangianBound::LagrangianBound(const BaseAncestryGraph& G,
+                                 const RealIntervalMatrix& F_interval_clustered,
+                                 const RealMatrix& F_point_unclustered,
+                                 const StlIntMatrix& toUnclusteredColumn)
+  : _G(G)
+  , _F_interval_clustered(F_interval_clustered)
+  , _rootCandidate(F_interval_clustered.getNrCols(), true)
+  , _F_interval_nonroot(F_interval_clustered)
+  , _inArcs(F_interval_clustered.getNrCols())
+  , _minDeviation(0)
+  , _sizeBound(F_interval_clustered.getNrCols())
+  , _nrIterations(0)
+  , _ub()
+{
+  assert(_G.isDAG());
+  
+  const Digraph& g = _G.getG();
+  for (ArcIt a(g); a != lemon::INVALID; ++a)
+  {
+    _inArcs[_G.mapNodeToColumn(g.target(a))].push_back(_G.mapNodeToColumn(g.source(a)));
+  }
+  
+  const int n = _F_interval_clustered.getNrCols();
+  for (int j = 0; j < n; ++j)
+  {
+    _minDeviation += Solver::minDeviation(j,
+                                          _F_interval_clustered,
+                                          F_point_unclustered,
+                                          toUnclusteredColumn);
+  }
+}
+
+double LagrangianBound::solveRelaxation(const StlDoubleMatrix& lambda,
+                                        StlIntVector& parent,
+                                        StlDoubleMatrix& f) const
+{
+  const int m = _F_interval_clustered.getNrRows();
+  const int n = _F_interval_clustered.getNrCols();
+  
+  // v_k gains 1 + sum_i (lambda[k][i] - lambda[j][i]) f[i][k] when attached
+  // to v_j and 1 + sum_i lambda[k][i] f[i][k] as the root, where f[i][k]
+  // is chosen within its interval to maximize the gain
+  double value = 0;
+  int root = -1;
+  double rootWeight = 0;
+  parent = StlIntVector(n, -2);
+  for (int k = 0; k < n; ++k)
+  {
+    double weight = 0;
+    for (StlIntVectorIt it = _inArcs[k].begin(); it != _inArcs[k].end(); ++it)
+    {
+      double w = 1;
+      for (int i = 0; i < m; ++i)
+      {
+        double d = lambda[k][i] - lambda[*it][i];
+        w += d * (d > 0 ? _ub[k][i] : _F_interval_nonroot(i, k).first);
+      }
+      if (w > weight)
+      {
+        weight = w;
+        parent[k] = *it;
+      }
+    }
+    value += weight;
+    
+    // the root replaces the in-arc of its vertex
+    double gain = 1;
+    for (int i = 0; i < m; ++i)
+    {
+      gain += lambda[k][i] * _ub[k][i];
+    }
+    if (_rootCandidate[k] && (root == -1 || gain - weight > rootWeight))
+    {
+      root = k;
+      rootWeight = gain - weight;
+    }
+  }
+  
+  if (root == -1)
+  {
+    return 0;
+  }
+  parent[root] = -1;
+  
+  for (int k = 0; k < n; ++k)
+  {
+    for (int i = 0; i < m; ++i)
+    {
+      if (parent[k] == -2)
+      {
+        f[k][i] = 0;
+      }
+      else if (parent[k] == -1 || lambda[k][i] > lambda[parent[k]][i])
+      {
+        f[k][i] = _ub[k][i];
+      }
+      else
+      {
+        f[k][i] = _F_interval_nonroot(i, k).first;
+      }
+    }
+  }
+  
+  return value + rootWeight;
+}
+  
+int LagrangianBound::run(int nrIterations, int lowerBound)
+{
+  const int m = _F_interval_clustered.getNrRows();
+  const int n = _F_interval_clustered.getNrCols();
+  
+  _ub = StlDoubleMatrix(n, StlDoubleVector(m, 0));
+  for (int j = 0; j < n; ++j)
+  {
+    for (int i = 0; i < m; ++i)
+    {
+      _ub[j][i] = std::min(0.5, _F_interval_clustered(i, j).second);
+    }
+  }
+  
+  // Polyak steps towards the size of the known tree, the step length is
+  // halved whenever the bound did not improve for a few iterations
+  const double target = std::max(1, lowerBound);
+  double theta = 2;
+  int nrStalled = 0;
+  double bestValue = n + 1;
+  
+  StlDoubleMatrix lambda(n, StlDoubleVector(m, 0));
+  StlDoubleMatrix f(n, StlDoubleVector(m, 0));
+  StlDoubleMatrix subgradient(n, StlDoubleVector(m, 0));
+  StlIntVector parent;
+  
+  _sizeBound = n;
+  for (_nrIterations = 0; _nrIterations < nrIterations && _sizeBound > lowerBound;)
+  {
+    double value = solveRelaxation(lambda, parent, f);
+    ++_nrIterations;
+    
+    if (value < bestValue - 1e-6)
+    {
+      bestValue = value;
+      nrStalled = 0;
+      // the number of vertices is integral
+      _sizeBound = std::min(_sizeBound, static_cast<int>(floor(bestValue + 1e-6)));
+    }
+    else if (++nrStalled == 5)
+    {
+      theta /= 2;
+      nrStalled = 0;
+    }
+    
+    // the sum rule rows evaluated at the solution of the relaxation
+    subgradient = f;
+    for (int k = 0; k < n; ++k)
+    {
+      if (parent[k] >= 0)
+      {
+        for (int i = 0; i < m; ++i)
+        {
+          subgradient[parent[k]][i] -= f[k][i];
+        }
+      }
+    }
+    double norm = 0;
+    for (int j = 0; j < n; ++j)
+    {
+      for (int i = 0; i < m; ++i)
+      {
+        // multipliers at 0 remain there if their row is satisfied
+        if (lambda[j][i] > 0 || subgradient[j][i] < 0)
+        {
+          norm += subgradient[j][i] * subgradient[j][i];
+        }
+      }
+    }
+    
+    if (norm == 0)
+    {
+      // the solution of the relaxation satisfies the sum rule
+      break;
+    }
+    
+    double step = theta * std::max(value - target, 1e-3) / norm;
+    for (int j = 0; j < n; ++j)
+    {
+      for (int i = 0; i < m; ++i)
+      {
+        lambda[j][i] = std::max(0.0, lambda[j][i] - step * subgradient[j][i]);
+      }
+    }
+  }
+  
+  return _sizeBound;
+}
+  
+} // namespace vaff
@@ -0,0 +1,88 @@
+/*
+ *  lagrangianbound.h
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#ifndef LAGRANGIANBOUND_H
+#define LAGRANGIANBOUND_H
+
+#include "utils.h"
+#include "baseancestrygraph.h"
+#include "realintervalmatrix.h"
+#include "realmatrix.h"
+
+namespace vaff {
+
+// upper bound on the number of vertices of a tree by Lagrangian relaxation
+// of the sum rule rows f[i][j] - sum_{(j,k)} f[i][k] x[(j,k)] >= 0 with
+// multipliers lambda[j][i] >= 0; what remains is a maximum weight branching
+// with a single root, in which every vertex picks its corrected VAFs
+// independently, and its value is minimized over lambda by subgradient steps
+class LagrangianBound
+{
+public:
+  typedef BaseAncestryGraph::Digraph Digraph;
+  DIGRAPH_TYPEDEFS(Digraph);
+  
+  LagrangianBound(const BaseAncestryGraph& G,
+                  const RealIntervalMatrix& F_interval_clustered,
+                  const RealMatrix& F_point_unclustered,
+                  const StlIntMatrix& toUnclusteredColumn);
+  
+  void applyPresolve(const StlBoolVector& rootCandidate,
+                     const RealIntervalMatrix& F_interval_nonroot)
+  {
+    _rootCandidate = rootCandidate;
+    _F_interval_nonroot = F_interval_nonroot;
+  }
+  
+  // performs at most nrIterations subgradient steps, stopping as soon as
+  // the bound does not exceed lowerBound, the size of a known tree;
+  // returns the bound on the number of vertices
+  int run(int nrIterations, int lowerBound);
+  
+  int getSizeBound() const
+  {
+    return _sizeBound;
+  }
+  
+  // upper bound on the objective value: the VAF deviation is at least the
+  // sum of the smallest deviations of the vertices
+  double getObjBound() const
+  {
+    return _sizeBound - _minDeviation;
+  }
+  
+  int getNrIterations() const
+  {
+    return _nrIterations;
+  }
+
+private:
+  const BaseAncestryGraph& _G;
+  const RealIntervalMatrix& _F_interval_clustered;
+  StlBoolVector _rootCandidate;
+  RealIntervalMatrix _F_interval_nonroot;
+  // _inArcs[k] : columns j such that (v_j,v_k) is an arc
+  StlIntMatrix _inArcs;
+  double _minDeviation;
+  
+  int _sizeBound;
+  int _nrIterations;
+  // _ub[j][i] : upper bound on f[i][j]
+  StlDoubleMatrix _ub;
+  
+  // solves the relaxation for multipliers lambda, returns its value; as G
+  // is a DAG, Edmonds' algorithm amounts to picking the heaviest positive
+  // in-arc of every vertex, parent is as in Solver::computeFrequencies and
+  // f[j][i] is the corrected VAF of v_j in sample i
+  double solveRelaxation(const StlDoubleMatrix& lambda,
+                         StlIntVector& parent,
+                         StlDoubleMatrix& f) const;
+};
+
+} // namespace vaff
+
+#endif // LAGRANGIANBOUND_H
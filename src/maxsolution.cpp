@@ -35,15 +35,42 @@ std::istream& operator>>(std::istream& in,
 MaxSolution::MaxSolution(const RealMatrix& F)
   : _F(F)
   , _triples()
+  , _index()
 {
 }
   
 MaxSolution::MaxSolution()
   : _F()
   , _triples()
+  , _index()
 {
 }
   
+size_t MaxSolution::hash(const Triple& sol)
+{
+  std::hash<double> hashValue;
+  std::hash<StlBoolVector> hashRow;
+  
+  size_t h = 0;
+  const StlBoolMatrix& B = sol._T.getB().getMatrix();
+  for (StlBoolMatrix::const_iterator it = B.begin(); it != B.end(); ++it)
+  {
+    h ^= hashRow(*it) + 0x9e3779b9 + (h << 6) + (h >> 2);
+  }
+  
+  const int m = sol._F.getNrRows();
+  const int n = sol._F.getNrCols();
+  for (int j = 0; j < n; ++j)
+  {
+    for (int i = 0; i < m; ++i)
+    {
+      h ^= hashValue(sol._F(i, j)) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    }
+  }
+  
+  return h;
+}
+  
 double MaxSolution::computeVafDelta(int sol_idx) const
 {
   typedef std::vector<std::string> StringVector;
@@ -156,6 +183,13 @@ void MaxSolution::remapLabels(int max_cluster_size = 10)
       sol._F.setColLabel(j, new_label);
     }
   }
+  
+  // the labels are part of the hash
+  _index.clear();
+  for (int idx = 0; idx < size(); ++idx)
+  {
+    _index.insert(std::make_pair(hash(_triples[idx]), idx));
+  }
 }
   
 std::ostream& operator<<(std::ostream& out,
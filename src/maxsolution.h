@@ -11,6 +11,7 @@
 #include "utils.h"
 #include "realmatrix.h"
 #include "clonaltree.h"
+#include <unordered_map>
 
 namespace vaff {
 
@@ -49,6 +50,7 @@ public:
   
   void add(const Triple& triple)
   {
+    _index.insert(std::make_pair(hash(triple), static_cast<int>(_triples.size())));
     _triples.push_back(triple);
   }
   
@@ -66,13 +68,16 @@ public:
   void clear()
   {
     _triples.clear();
+    _index.clear();
   }
   
+  // only triples with the same hash are compared
   bool present(const Triple& sol) const
   {
-    for (TripleVectorIt it = _triples.begin(); it != _triples.end(); ++it)
+    std::pair<HashIndexIt, HashIndexIt> range = _index.equal_range(hash(sol));
+    for (HashIndexIt it = range.first; it != range.second; ++it)
     {
-      if (*it == sol)
+      if (_triples[it->second] == sol)
       {
         return true;
       }
@@ -81,6 +86,10 @@ public:
     return false;
   }
   
+  // hash of the tree and the frequencies of sol, consistent with
+  // Triple::operator==, which does not compare column labels
+  static size_t hash(const Triple& sol);
+  
   const RealMatrix& getF() const
   {
     return _F;
@@ -99,8 +108,13 @@ public:
                                   MaxSolution& solution);
   
 private:
+  // maps the hash of every triple to its index
+  typedef std::unordered_multimap<size_t, int> HashIndex;
+  typedef HashIndex::const_iterator HashIndexIt;
+  
   RealMatrix _F;
   TripleVector _triples;
+  HashIndex _index;
   
   typedef TripleVector::iterator TripleVectorNonConstIt;
 };
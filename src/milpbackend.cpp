@@ -0,0 +1,56 @@
+/*
+ *  milpbackend.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "config.h"
+#include "milpbackend.h"
+#ifdef HAVE_CPLEX
+#include "cplexbackend.h"
+#endif
+#ifdef HAVE_HIGHS
+#include "highsbackend.h"
+#endif
+
+namespace vaff {
+
+MilpBackend::StringVector MilpBackend::getAvailable()
+{
+  StringVector res;
+#ifdef HAVE_CPLEX
+  res.push_back("cplex");
+#endif
+#ifdef HAVE_HIGHS
+  res.push_back("highs");
+#endif
+  return res;
+}
+
+MilpBackend* MilpBackend::create(const std::string& name)
+{
+  StringVector available = getAvailable();
+  if (available.empty())
+  {
+    return NULL;
+  }
+  
+  const std::string& backend = name.empty() ? available.front() : name;
+#ifdef HAVE_CPLEX
+  if (backend == "cplex")
+  {
+    return new CplexBackend();
+  }
+#endif
+#ifdef HAVE_HIGHS
+  if (backend == "highs")
+  {
+    return new HighsBackend();
+  }
+#endif
+  
+  return NULL;
+}
+
+} // namespace vaff
@@ -0,0 +1,136 @@
+/*
+ *  milpbackend.h
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#ifndef MILPBACKEND_H
+#define MILPBACKEND_H
+
+#include "milpmodel.h"
+
+namespace vaff {
+
+// separates valid inequalities row <= ub from a fractional solution
+class MilpCutSeparator
+{
+public:
+  virtual ~MilpCutSeparator()
+  {
+  }
+  
+  virtual void separate(const StlDoubleVector& values,
+                        MilpRowVector& rows,
+                        StlDoubleVector& ub) const = 0;
+};
+
+// notified of every improving incumbent found while solving, possibly from
+// several backend threads
+class MilpIncumbentListener
+{
+public:
+  virtual ~MilpIncumbentListener()
+  {
+  }
+  
+  virtual void improved(const StlDoubleVector& values,
+                        double objValue,
+                        double bound) = 0;
+};
+
+// notified periodically while solving, possibly from several backend threads
+class MilpProgressListener
+{
+public:
+  virtual ~MilpProgressListener()
+  {
+  }
+  
+  // objValue is only meaningful if hasIncumbent holds
+  virtual void progress(long long nrNodes,
+                        bool hasIncumbent,
+                        double objValue,
+                        double bound) = 0;
+};
+
+class MilpBackend
+{
+public:
+  typedef std::vector<std::string> StringVector;
+  
+  virtual ~MilpBackend()
+  {
+  }
+  
+  virtual std::string getName() const = 0;
+  
+  // the model must outlive the backend and is not modified after loading
+  virtual void load(const MilpModel& model) = 0;
+  
+  // backends that do not support lazy rows leave them out upon loading
+  virtual bool supportsLazyRows() const
+  {
+    return false;
+  }
+  
+  virtual bool supportsCutSeparator() const
+  {
+    return false;
+  }
+  
+  virtual void setCutSeparator(const MilpCutSeparator* pSeparator)
+  {
+    assert(supportsCutSeparator() || !pSeparator);
+  }
+  
+  // ignored by backends without incumbent callbacks
+  virtual void setIncumbentListener(MilpIncumbentListener* pListener)
+  {
+  }
+  
+  // ignored by backends without progress callbacks
+  virtual void setProgressListener(MilpProgressListener* pListener)
+  {
+  }
+  
+  // ignored by backends without per instance threading
+  virtual void setNrThreads(int nrThreads)
+  {
+  }
+  
+  // values of all columns of a feasible solution, must be called after load
+  virtual void setMipStart(const StlDoubleVector& values) = 0;
+  
+  // changes the bounds of a column of the loaded model
+  virtual void setColBounds(int col, double lb, double ub) = 0;
+  
+  // appends lb <= row <= ub to the loaded model, e.g. to exclude a solution
+  virtual void addRow(const MilpRow& row, double lb, double ub) = 0;
+  
+  virtual bool solve(int timeLimit) = 0;
+  
+  virtual double solveRelaxation() = 0;
+  
+  // objective value of the incumbent
+  virtual double getObjValue() const = 0;
+  
+  // number of solutions in the pool
+  virtual int getNrSolutions() const = 0;
+  
+  virtual double getObjValue(int solIdx) const = 0;
+  
+  virtual double getBestObjValue() const = 0;
+  
+  virtual void getValues(int solIdx, StlDoubleVector& values) const = 0;
+  
+  // names of the backends compiled in, the first one is the default
+  static StringVector getAvailable();
+  
+  // returns NULL if name is not available, an empty name selects the default
+  static MilpBackend* create(const std::string& name);
+};
+
+} // namespace vaff
+
+#endif // MILPBACKEND_H
@@ -0,0 +1,244 @@
+/*
+ *  milpmodel.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "milpmodel.h"
+#include <cmath>
+
+namespace vaff {
+
+MilpModel::MilpModel()
+  : _maximize(true)
+  , _colLB()
+  , _colUB()
+  , _colObj()
+  , _colType()
+  , _colName()
+  , _rowStart(1, 0)
+  , _rowIndex()
+  , _rowValue()
+  , _rowLB()
+  , _rowUB()
+  , _rowLazy()
+{
+}
+
+int MilpModel::addCol(double lb,
+                      double ub,
+                      double obj,
+                      ColType type,
+                      const std::string& name)
+{
+  int col = _colLB.size();
+  _colLB.push_back(lb);
+  _colUB.push_back(ub);
+  _colObj.push_back(obj);
+  _colType.push_back(type);
+  
+  if (name.empty())
+  {
+    char buf[1024];
+    snprintf(buf, 1024, "C%d", col);
+    _colName.push_back(buf);
+  }
+  else
+  {
+    _colName.push_back(name);
+  }
+  
+  return col;
+}
+
+int MilpModel::addRow(const MilpRow& row,
+                      double lb,
+                      double ub)
+{
+  int r = _rowLB.size();
+  const StlIntVector& index = row.getIndices();
+  const StlDoubleVector& value = row.getValues();
+  for (int k = 0; k < row.size(); ++k)
+  {
+    assert(0 <= index[k] && index[k] < getNrCols());
+    _rowIndex.push_back(index[k]);
+    _rowValue.push_back(value[k]);
+  }
+  _rowStart.push_back(_rowIndex.size());
+  _rowLB.push_back(lb);
+  _rowUB.push_back(ub);
+  _rowLazy.push_back(false);
+  
+  return r;
+}
+
+double MilpModel::getRowActivity(int row, const StlDoubleVector& values) const
+{
+  double sum = 0;
+  for (int k = _rowStart[row]; k < _rowStart[row + 1]; ++k)
+  {
+    sum += _rowValue[k] * values[_rowIndex[k]];
+  }
+  return sum;
+}
+
+int MilpModel::countViolations(const StlDoubleVector& values, double tol) const
+{
+  assert(static_cast<int>(values.size()) == getNrCols());
+  
+  int res = 0;
+  for (int j = 0; j < getNrCols(); ++j)
+  {
+    if (values[j] < _colLB[j] - tol || values[j] > _colUB[j] + tol)
+    {
+      ++res;
+    }
+  }
+  
+  for (int r = 0; r < getNrRows(); ++r)
+  {
+    double sum = getRowActivity(r, values);
+    if (sum < _rowLB[r] - tol || sum > _rowUB[r] + tol)
+    {
+      ++res;
+    }
+  }
+  
+  return res;
+}
+
+void MilpModel::writeMPS(std::ostream& out, const std::string& name) const
+{
+  const int nrCols = getNrCols();
+  const int nrRows = getNrRows();
+  
+  // coefficients by column
+  StlIntMatrix colRows(nrCols);
+  StlDoubleMatrix colValues(nrCols);
+  for (int r = 0; r < nrRows; ++r)
+  {
+    for (int k = _rowStart[r]; k < _rowStart[r + 1]; ++k)
+    {
+      colRows[_rowIndex[k]].push_back(r);
+      colValues[_rowIndex[k]].push_back(_rowValue[k]);
+    }
+  }
+  
+  out.precision(17);
+  out << "NAME " << name << std::endl;
+  out << "OBJSENSE" << std::endl << "    " << (_maximize ? "MAX" : "MIN") << std::endl;
+  
+  out << "ROWS" << std::endl;
+  out << " N  OBJ" << std::endl;
+  for (int r = 0; r < nrRows; ++r)
+  {
+    const bool hasLB = !std::isinf(_rowLB[r]);
+    const bool hasUB = !std::isinf(_rowUB[r]);
+    if (hasLB && hasUB && _rowLB[r] == _rowUB[r])
+    {
+      out << " E  R" << r << std::endl;
+    }
+    else if (hasLB)
+    {
+      out << " G  R" << r << std::endl;
+    }
+    else if (hasUB)
+    {
+      out << " L  R" << r << std::endl;
+    }
+    else
+    {
+      out << " N  R" << r << std::endl;
+    }
+  }
+  
+  out << "COLUMNS" << std::endl;
+  bool integral = false;
+  int nrMarkers = 0;
+  for (int j = 0; j < nrCols; ++j)
+  {
+    if ((_colType[j] == BINARY) != integral)
+    {
+      integral = !integral;
+      out << "    MARKER" << nrMarkers++ << " 'MARKER' "
+          << (integral ? "'INTORG'" : "'INTEND'") << std::endl;
+    }
+    
+    if (_colObj[j] != 0)
+    {
+      out << "    " << _colName[j] << " OBJ " << _colObj[j] << std::endl;
+    }
+    for (size_t k = 0; k < colRows[j].size(); ++k)
+    {
+      out << "    " << _colName[j] << " R" << colRows[j][k] << " " << colValues[j][k] << std::endl;
+    }
+  }
+  if (integral)
+  {
+    out << "    MARKER" << nrMarkers++ << " 'MARKER' 'INTEND'" << std::endl;
+  }
+  
+  out << "RHS" << std::endl;
+  for (int r = 0; r < nrRows; ++r)
+  {
+    const bool hasLB = !std::isinf(_rowLB[r]);
+    double rhs = hasLB ? _rowLB[r] : _rowUB[r];
+    if (!std::isinf(rhs) && rhs != 0)
+    {
+      out << "    RHS R" << r << " " << rhs << std::endl;
+    }
+  }
+  
+  // G rows with a finite upper bound become ranges [lb, lb + |R|]
+  bool first = true;
+  for (int r = 0; r < nrRows; ++r)
+  {
+    if (!std::isinf(_rowLB[r]) && !std::isinf(_rowUB[r]) && _rowLB[r] != _rowUB[r])
+    {
+      if (first)
+      {
+        out << "RANGES" << std::endl;
+        first = false;
+      }
+      out << "    RNG R" << r << " " << _rowUB[r] - _rowLB[r] << std::endl;
+    }
+  }
+  
+  out << "BOUNDS" << std::endl;
+  for (int j = 0; j < nrCols; ++j)
+  {
+    const double lb = _colLB[j];
+    const double ub = _colUB[j];
+    if (lb == ub)
+    {
+      out << " FX BND " << _colName[j] << " " << lb << std::endl;
+      continue;
+    }
+    
+    if (std::isinf(lb))
+    {
+      out << " MI BND " << _colName[j] << std::endl;
+    }
+    else if (lb != 0)
+    {
+      out << " LO BND " << _colName[j] << " " << lb << std::endl;
+    }
+    
+    if (std::isinf(ub))
+    {
+      if (_colType[j] == BINARY)
+      {
+        out << " PL BND " << _colName[j] << std::endl;
+      }
+    }
+    else
+    {
+      out << " UP BND " << _colName[j] << " " << ub << std::endl;
+    }
+  }
+  
+  out << "ENDATA" << std::endl;
+}
+
+} // namespace vaff
@@ -0,0 +1,224 @@
+/*
+ *  milpmodel.h
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#ifndef MILPMODEL_H
+#define MILPMODEL_H
+
+#include "utils.h"
+#include <string>
+#include <vector>
+#include <limits>
+
+namespace vaff {
+
+// sparse row sum_k value[k] * x[index[k]]
+class MilpRow
+{
+public:
+  void add(int col, double value)
+  {
+    _index.push_back(col);
+    _value.push_back(value);
+  }
+  
+  void clear()
+  {
+    _index.clear();
+    _value.clear();
+  }
+  
+  int size() const
+  {
+    return _index.size();
+  }
+  
+  const StlIntVector& getIndices() const
+  {
+    return _index;
+  }
+  
+  const StlDoubleVector& getValues() const
+  {
+    return _value;
+  }
+
+private:
+  StlIntVector _index;
+  StlDoubleVector _value;
+};
+
+typedef std::vector<MilpRow> MilpRowVector;
+
+// solver independent mixed integer linear program, rows are stored in
+// compressed sparse row format; lazy rows are only enforced once violated
+class MilpModel
+{
+public:
+  enum ColType
+  {
+    CONTINUOUS,
+    BINARY
+  };
+  
+  static double infinity()
+  {
+    return std::numeric_limits<double>::infinity();
+  }
+  
+  MilpModel();
+  
+  int addCol(double lb,
+             double ub,
+             double obj,
+             ColType type,
+             const std::string& name);
+  
+  // lb <= row <= ub
+  int addRow(const MilpRow& row,
+             double lb,
+             double ub);
+  
+  void setColLB(int col, double lb)
+  {
+    assert(0 <= col && col < getNrCols());
+    _colLB[col] = lb;
+  }
+  
+  void setColUB(int col, double ub)
+  {
+    assert(0 <= col && col < getNrCols());
+    _colUB[col] = ub;
+  }
+  
+  void setColObj(int col, double obj)
+  {
+    assert(0 <= col && col < getNrCols());
+    _colObj[col] = obj;
+  }
+  
+  void setRowLazy(int row, bool lazy)
+  {
+    assert(0 <= row && row < getNrRows());
+    _rowLazy[row] = lazy;
+  }
+  
+  void setMaximize(bool maximize)
+  {
+    _maximize = maximize;
+  }
+  
+  bool isMaximize() const
+  {
+    return _maximize;
+  }
+  
+  int getNrCols() const
+  {
+    return _colLB.size();
+  }
+  
+  int getNrRows() const
+  {
+    return _rowLB.size();
+  }
+  
+  int getNrNonZeros() const
+  {
+    return _rowIndex.size();
+  }
+  
+  double getColLB(int col) const
+  {
+    return _colLB[col];
+  }
+  
+  double getColUB(int col) const
+  {
+    return _colUB[col];
+  }
+  
+  double getColObj(int col) const
+  {
+    return _colObj[col];
+  }
+  
+  ColType getColType(int col) const
+  {
+    return _colType[col];
+  }
+  
+  const std::string& getColName(int col) const
+  {
+    return _colName[col];
+  }
+  
+  // the coefficients of row r are at positions [getRowStart(r), getRowStart(r+1))
+  int getRowStart(int row) const
+  {
+    return _rowStart[row];
+  }
+  
+  int getRowIndex(int k) const
+  {
+    return _rowIndex[k];
+  }
+  
+  double getRowValue(int k) const
+  {
+    return _rowValue[k];
+  }
+  
+  double getRowLB(int row) const
+  {
+    return _rowLB[row];
+  }
+  
+  double getRowUB(int row) const
+  {
+    return _rowUB[row];
+  }
+  
+  bool isRowLazy(int row) const
+  {
+    return _rowLazy[row];
+  }
+  
+  int getNrLazyRows() const
+  {
+    return std::count(_rowLazy.begin(), _rowLazy.end(), true);
+  }
+  
+  double getRowActivity(int row, const StlDoubleVector& values) const;
+  
+  // number of column bounds and rows violated by values by more than tol
+  int countViolations(const StlDoubleVector& values, double tol) const;
+  
+  void writeMPS(std::ostream& out, const std::string& name) const;
+
+private:
+  typedef std::vector<ColType> ColTypeVector;
+  typedef std::vector<std::string> StringVector;
+  
+  bool _maximize;
+  
+  StlDoubleVector _colLB;
+  StlDoubleVector _colUB;
+  StlDoubleVector _colObj;
+  ColTypeVector _colType;
+  StringVector _colName;
+  
+  StlIntVector _rowStart;
+  StlIntVector _rowIndex;
+  StlDoubleVector _rowValue;
+  StlDoubleVector _rowLB;
+  StlDoubleVector _rowUB;
+  StlBoolVector _rowLazy;
+};
+
+} // namespace vaff
+
+#endif // MILPMODEL_H
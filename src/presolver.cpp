@@ -0,0 +1,276 @@
+/*
+ *  presolver.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "presolver.h"
+#include <lemon/bfs.h>
+#include <lemon/connectivity.h>
+
+namespace vaff {
+
+Presolver::Presolver(BaseAncestryGraph& H,
+                     const RealIntervalMatrix& F_interval_clustered)
+  : _H(H)
+  , _F_interval_clustered(F_interval_clustered)
+  , _rootCandidate(F_interval_clustered.getNrCols(), true)
+  , _F_interval_nonroot(F_interval_clustered)
+  , _removedByInterval(0)
+  , _removedByRoot(0)
+  , _fixedRoots(0)
+  , _tightenedBounds(0)
+  , _lowerBound(1)
+{
+  const int m = _F_interval_clustered.getNrRows();
+  const int n = _F_interval_clustered.getNrCols();
+  
+  // f <= 0.5 in the ILP, so a cluster with a lower bound above 0.5 is
+  // never in the tree and in particular not its root
+  for (int i = 0; i < m; ++i)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      RealInterval interval = _F_interval_clustered(i, j);
+      interval.second = std::min(0.5, interval.second);
+      _F_interval_nonroot.set(i, j, interval);
+      if (!feasible(i, j) && _rootCandidate[j])
+      {
+        _rootCandidate[j] = false;
+        ++_fixedRoots;
+      }
+    }
+  }
+}
+
+void Presolver::run()
+{
+  assert(_H.isDAG());
+  
+  NodeVector order;
+  topologicalOrder(order);
+  
+  bool changed = true;
+  while (changed)
+  {
+    changed = removeArcs();
+    changed |= fixRoots(order);
+    changed |= tightenBounds(order);
+  }
+}
+
+bool Presolver::removeArcs()
+{
+  const Digraph& G = _H.getG();
+  const int m = _F_interval_clustered.getNrRows();
+  
+  std::vector<Arc> toRemove;
+  for (ArcIt a(G); a != lemon::INVALID; ++a)
+  {
+    int j = _H.mapNodeToColumn(G.source(a));
+    int k = _H.mapNodeToColumn(G.target(a));
+    
+    // v_j is neither a root nor reachable from one
+    if (!_rootCandidate[j] && InArcIt(G, G.source(a)) == lemon::INVALID)
+    {
+      toRemove.push_back(a);
+      ++_removedByRoot;
+      continue;
+    }
+    
+    // the sum rule requires f[i][k] <= f[i][j]
+    for (int i = 0; i < m; ++i)
+    {
+      double ub_ij = _rootCandidate[j] ? _F_interval_clustered(i, j).second
+                                       : _F_interval_nonroot(i, j).second;
+      ub_ij = std::min(0.5, ub_ij);
+      if (g_tol.less(ub_ij, _F_interval_clustered(i, k).first))
+      {
+        toRemove.push_back(a);
+        ++_removedByInterval;
+        break;
+      }
+    }
+  }
+  
+  for (std::vector<Arc>::const_iterator it = toRemove.begin(); it != toRemove.end(); ++it)
+  {
+    _H.removeArc(*it);
+  }
+  
+  return !toRemove.empty();
+}
+
+bool Presolver::fixRoots(const NodeVector& order)
+{
+  const Digraph& G = _H.getG();
+  
+  _lowerBound = longestFeasiblePath(order);
+  
+  // a tree with s nodes has objective value in [s - 0.5, s], so a root
+  // that reaches fewer than _lowerBound nodes is never optimal
+  bool changed = false;
+  lemon::Bfs<Digraph> bfs(G);
+  for (NodeIt v(G); v != lemon::INVALID; ++v)
+  {
+    int j = _H.mapNodeToColumn(v);
+    if (!_rootCandidate[j])
+    {
+      continue;
+    }
+    
+    bfs.run(v);
+    int reach = 0;
+    for (NodeIt u(G); u != lemon::INVALID; ++u)
+    {
+      if (bfs.reached(u))
+      {
+        ++reach;
+      }
+    }
+    
+    if (reach < _lowerBound)
+    {
+      _rootCandidate[j] = false;
+      ++_fixedRoots;
+      changed = true;
+    }
+  }
+  
+  return changed;
+}
+
+bool Presolver::tightenBounds(const NodeVector& order)
+{
+  const Digraph& G = _H.getG();
+  const int m = _F_interval_clustered.getNrRows();
+  
+  // a non-root node has a parent, so f[i][k] is at most the largest
+  // upper bound among its possible parents
+  bool changed = false;
+  for (NodeVector::const_iterator it = order.begin(); it != order.end(); ++it)
+  {
+    Node v_k = *it;
+    int k = _H.mapNodeToColumn(v_k);
+    if (InArcIt(G, v_k) == lemon::INVALID)
+    {
+      continue;
+    }
+    
+    for (int i = 0; i < m; ++i)
+    {
+      double ub = 0;
+      for (InArcIt a(G, v_k); a != lemon::INVALID; ++a)
+      {
+        int j = _H.mapNodeToColumn(G.source(a));
+        double ub_ij = _rootCandidate[j] ? _F_interval_clustered(i, j).second
+                                         : _F_interval_nonroot(i, j).second;
+        ub = std::max(ub, std::min(0.5, ub_ij));
+      }
+      
+      RealInterval interval = _F_interval_nonroot(i, k);
+      if (g_tol.less(ub, interval.second))
+      {
+        interval.second = ub;
+        _F_interval_nonroot.set(i, k, interval);
+        ++_tightenedBounds;
+        changed = true;
+      }
+    }
+  }
+  
+  return changed;
+}
+
+int Presolver::longestFeasiblePath(const NodeVector& order) const
+{
+  const Digraph& G = _H.getG();
+  const int m = _F_interval_clustered.getNrRows();
+  
+  // greedy: extend the longest path ending at a parent while keeping
+  // f non-increasing, cap[v] is the largest f along the path ending at v
+  IntNodeMap length(G, 0);
+  Digraph::NodeMap<StlDoubleVector> cap(G);
+  
+  int res = 1;
+  for (NodeVector::const_iterator it = order.begin(); it != order.end(); ++it)
+  {
+    Node v_k = *it;
+    int k = _H.mapNodeToColumn(v_k);
+    
+    cap[v_k] = StlDoubleVector(m, 0);
+    bool feasible_k = true;
+    for (int i = 0; i < m && feasible_k; ++i)
+    {
+      feasible_k = feasible(i, k);
+    }
+    if (!feasible_k)
+    {
+      continue;
+    }
+    
+    if (_rootCandidate[k])
+    {
+      length[v_k] = 1;
+      for (int i = 0; i < m; ++i)
+      {
+        cap[v_k][i] = std::min(0.5, _F_interval_clustered(i, k).second);
+      }
+    }
+    
+    for (InArcIt a(G, v_k); a != lemon::INVALID; ++a)
+    {
+      Node v_j = G.source(a);
+      if (length[v_j] == 0 || length[v_j] + 1 <= length[v_k])
+      {
+        continue;
+      }
+      
+      bool feasible = true;
+      for (int i = 0; i < m && feasible; ++i)
+      {
+        feasible = !g_tol.less(cap[v_j][i], _F_interval_clustered(i, k).first);
+      }
+      
+      if (feasible)
+      {
+        length[v_k] = length[v_j] + 1;
+        for (int i = 0; i < m; ++i)
+        {
+          cap[v_k][i] = std::min(cap[v_j][i],
+                                 std::min(0.5, _F_interval_clustered(i, k).second));
+        }
+      }
+    }
+    
+    res = std::max(res, length[v_k]);
+  }
+  
+  return res;
+}
+
+void Presolver::topologicalOrder(NodeVector& order) const
+{
+  const Digraph& G = _H.getG();
+  
+  IntNodeMap index(G);
+  lemon::topologicalSort(G, index);
+  
+  order = NodeVector(lemon::countNodes(G), lemon::INVALID);
+  for (NodeIt v(G); v != lemon::INVALID; ++v)
+  {
+    order[index[v]] = v;
+  }
+}
+
+void Presolver::printReport(std::ostream& out) const
+{
+  out << "Removed arcs (interval)     : " << _removedByInterval << std::endl
+      << "Removed arcs (unreachable)  : " << _removedByRoot << std::endl
+      << "Fixed root variables        : " << _fixedRoots << std::endl
+      << "Tightened non-root bounds   : " << _tightenedBounds << std::endl
+      << "Feasible path length        : " << _lowerBound << std::endl;
+}
+
+} // namespace vaff
@@ -0,0 +1,90 @@
+/*
+ *  presolver.h
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#ifndef PRESOLVER_H
+#define PRESOLVER_H
+
+#include "utils.h"
+#include "baseancestrygraph.h"
+#include "realintervalmatrix.h"
+
+namespace vaff {
+
+class Presolver
+{
+public:
+  typedef BaseAncestryGraph::Digraph Digraph;
+  DIGRAPH_TYPEDEFS(Digraph);
+  typedef std::vector<Node> NodeVector;
+  
+  Presolver(BaseAncestryGraph& H,
+            const RealIntervalMatrix& F_interval_clustered);
+  
+  void run();
+  
+  // root candidates indexed by column
+  const StlBoolVector& getRootCandidates() const
+  {
+    return _rootCandidate;
+  }
+  
+  // bounds on f[i][j] that hold whenever v_j is a non-root node of the tree
+  const RealIntervalMatrix& getNonRootIntervals() const
+  {
+    return _F_interval_nonroot;
+  }
+  
+  int getNrRemovedArcs() const
+  {
+    return _removedByInterval + _removedByRoot;
+  }
+  
+  int getNrFixedRoots() const
+  {
+    return _fixedRoots;
+  }
+  
+  void printReport(std::ostream& out) const;
+
+private:
+  BaseAncestryGraph& _H;
+  const RealIntervalMatrix& _F_interval_clustered;
+  StlBoolVector _rootCandidate;
+  RealIntervalMatrix _F_interval_nonroot;
+  
+  // number of arcs (j,k) removed because f[i][k] > f[i][j] for some sample i
+  int _removedByInterval;
+  // number of arcs (j,k) removed because v_j cannot be in any tree
+  int _removedByRoot;
+  // number of root variables fixed to 0
+  int _fixedRoots;
+  // number of tightened upper bounds
+  int _tightenedBounds;
+  // size of a feasible tree, used to fix root variables
+  int _lowerBound;
+  
+  bool removeArcs();
+  
+  bool fixRoots(const NodeVector& order);
+  
+  bool tightenBounds(const NodeVector& order);
+  
+  int longestFeasiblePath(const NodeVector& order) const;
+  
+  void topologicalOrder(NodeVector& order) const;
+  
+  // whether the interval of cluster j in sample i meets the cap of 0.5
+  bool feasible(int i, int j) const
+  {
+    const RealInterval& interval = _F_interval_clustered(i, j);
+    return !g_tol.less(std::min(0.5, interval.second), interval.first);
+  }
+};
+
+} // namespace vaff
+
+#endif // PRESOLVER_H
@@ -41,6 +41,14 @@ void ProbAncestryGraph::constructGraph(const AncestryMatrix& A,
   int nn = A.getNrCols();
   for (int j = 0; j < nn; ++j)
   {
+    // mutations with identical read counts share the node of the first one
+    int rep_j = A.getRepresentative(j);
+    if (rep_j != j)
+    {
+      _columnToNode[j] = _columnToNode[rep_j];
+      continue;
+    }
+    
     bool feasible = true;
     for (int i = 0; i < CI.getNrRows(); ++i)
     {
@@ -97,6 +105,17 @@ void ProbAncestryGraph::removeCycles(const AncestryMatrix& A,
   {
     toOrgColumns[sccMap[v]].push_back(_nodeToColumn[v]);
   }
+  
+  // duplicates end up in the cluster of their node
+  const int nn = _columnToNode.size();
+  for (int j = 0; j < nn; ++j)
+  {
+    Node v_j = _columnToNode[j];
+    if (v_j != lemon::INVALID && _nodeToColumn[v_j] != j)
+    {
+      toOrgColumns[sccMap[v_j]].push_back(j);
+    }
+  }
 }
   
 void ProbAncestryGraph::contract(const AncestryMatrix& A,
@@ -7,6 +7,7 @@
 
 #include "readcountmatrix.h"
 #include <sstream>
+#include <unordered_map>
 #include <boost/algorithm/string.hpp>
 #include <boost/math/distributions/beta.hpp>
 
@@ -206,6 +207,68 @@ ReadCountMatrix ReadCountMatrix::collapse(StlIntMatrix& toOrgColumns) const
   return R;
 }
   
+size_t ReadCountMatrix::hashRow(int j, int nrSamples) const
+{
+  assert(0 <= j && j < _m);
+  assert(0 <= nrSamples && nrSamples <= _n);
+  
+  std::hash<int> hashValue;
+  
+  size_t h = 0;
+  for (int sample = 0; sample < nrSamples; ++sample)
+  {
+    h ^= hashValue(_C[j][sample]) + 0x9e3779b9 + (h << 6) + (h >> 2);
+    h ^= hashValue(_D[j][sample]) + 0x9e3779b9 + (h << 6) + (h >> 2);
+  }
+  
+  return h;
+}
+  
+ReadCountMatrix ReadCountMatrix::deduplicate(StlIntVector& toProfile) const
+{
+  typedef std::unordered_multimap<size_t, int> HashIndex;
+  typedef HashIndex::const_iterator HashIndexIt;
+  
+  // maps the hash of every distinct row to its first occurrence
+  HashIndex index;
+  StlIntVector representative;
+  toProfile = StlIntVector(_m, -1);
+  for (int j = 0; j < _m; ++j)
+  {
+    size_t h = hashRow(j);
+    std::pair<HashIndexIt, HashIndexIt> range = index.equal_range(h);
+    for (HashIndexIt it = range.first; it != range.second; ++it)
+    {
+      int k = it->second;
+      if (_C[k] == _C[j] && _D[k] == _D[j])
+      {
+        toProfile[j] = toProfile[k];
+        break;
+      }
+    }
+    
+    if (toProfile[j] == -1)
+    {
+      toProfile[j] = representative.size();
+      representative.push_back(j);
+      index.insert(std::make_pair(h, j));
+    }
+  }
+  
+  const int nrProfiles = representative.size();
+  ReadCountMatrix R(nrProfiles, _n);
+  R._colLabel = _colLabel;
+  for (int i = 0; i < nrProfiles; ++i)
+  {
+    int j = representative[i];
+    R._rowLabel[i] = _rowLabel[j];
+    R._C[i] = _C[j];
+    R._D[i] = _D[j];
+  }
+  
+  return R;
+}
+  
 void ReadCountMatrix::computeConfidenceIntervals(RealIntervalMatrix& CI,
                                                  double gamma) const
 {
@@ -89,6 +89,19 @@ public:
   
   ReadCountMatrix collapse(StlIntMatrix& toOrgColumns) const;
   
+  // returns the distinct rows in order of first occurrence, toProfile[j] is
+  // the row of the returned matrix with the same read counts as row j; only
+  // rows with the same hash are compared
+  ReadCountMatrix deduplicate(StlIntVector& toProfile) const;
+  
+  // hash of the alt and ref counts of row j in the first nrSamples samples
+  size_t hashRow(int j, int nrSamples) const;
+  
+  size_t hashRow(int j) const
+  {
+    return hashRow(j, _n);
+  }
+  
   bool operator==(const ReadCountMatrix& other) const
   {
     return _m == other._m && _n == other._n && _C == other._C && _D == other._D;
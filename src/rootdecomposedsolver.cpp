@@ -0,0 +1,242 @@
+/*
+ *  rootdecomposedsolver.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "rootdecomposedsolver.h"
+#include <thread>
+
+namespace vaff {
+
+RootDecomposedSolver::RootDecomposedSolver(const BaseAncestryGraph& G,
+                                           const RealIntervalMatrix& F_interval_clustered,
+                                           const RealMatrix& F_point_unclustered,
+                                           const StlIntMatrix& toUnclusteredColumn,
+                                           int timeLimit,
+                                           int nrThreads,
+                                           IntMaxIlpSolver::Formulation formulation,
+                                           const std::string& backend)
+  : Solver(G, F_interval_clustered, F_point_unclustered, toUnclusteredColumn, timeLimit)
+  , _nrThreads(nrThreads)
+  , _formulation(formulation)
+  , _backend(backend)
+  , _coverCuts(false)
+  , _rootCandidate(F_interval_clustered.getNrCols(), true)
+  , _F_interval_nonroot(F_interval_clustered)
+  , _minDeviation(F_interval_clustered.getNrCols(), 0)
+  , _subproblems()
+  , _next(0)
+  , _nrSolved(0)
+  , _nrPruned(0)
+  , _mutex()
+  , _pSolution(NULL)
+  , _objValue(0)
+  , _optimal(false)
+  , _timer()
+{
+  assert(_G.isDAG());
+  assert(_nrThreads > 0);
+  
+  const int n = _F_interval_clustered.getNrCols();
+  for (int j = 0; j < n; ++j)
+  {
+    _minDeviation[j] = minDeviation(j,
+                                    _F_interval_clustered,
+                                    _F_point_unclustered,
+                                    _toUnclusteredColumn);
+  }
+}
+
+void RootDecomposedSolver::solveSubproblem(const Subproblem& sub)
+{
+  const int m = _F_interval_clustered.getNrRows();
+  const int n = sub._columns.size();
+  
+  int timeLimit = -1;
+  if (_timeLimit > 0)
+  {
+    timeLimit = _timeLimit - static_cast<int>(_timer.realTime());
+    if (timeLimit <= 0)
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      _optimal = false;
+      return;
+    }
+  }
+  
+  BaseAncestryGraph H;
+  _G.induce(sub._columns, H);
+  
+  RealIntervalMatrix CI(m, n);
+  RealIntervalMatrix CI_nonroot(m, n);
+  StlIntMatrix toUnclusteredColumn(n);
+  double excludedDeviation = 0;
+  StlBoolVector included(_F_interval_clustered.getNrCols(), false);
+  for (int k = 0; k < n; ++k)
+  {
+    int j = sub._columns[k];
+    for (int i = 0; i < m; ++i)
+    {
+      CI.set(i, k, _F_interval_clustered(i, j));
+      CI_nonroot.set(i, k, _F_interval_nonroot(i, j));
+    }
+    toUnclusteredColumn[k] = _toUnclusteredColumn[j];
+    included[j] = true;
+  }
+  for (int j = 0; j < _F_interval_clustered.getNrCols(); ++j)
+  {
+    if (!included[j])
+    {
+      excludedDeviation += _minDeviation[j];
+    }
+  }
+  
+  // the root is fixed to the first column
+  StlBoolVector rootCandidate(n, false);
+  rootCandidate[0] = true;
+  
+  IntMaxIlpSolver ilp(H,
+                      CI,
+                      _F_point_unclustered,
+                      toUnclusteredColumn,
+                      timeLimit,
+                      _formulation,
+                      _backend);
+  ilp.applyPresolve(rootCandidate, CI_nonroot);
+  if (_coverCuts)
+  {
+    ilp.addCoverCuts();
+  }
+  ilp.setNrThreads(1);
+  
+  MaxSolution solution;
+  bool solved = ilp.solve(solution);
+  ++_nrSolved;
+  
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_timeLimit > 0 && _timer.realTime() > _timeLimit)
+  {
+    _optimal = false;
+  }
+  if (!solved || solution.size() == 0)
+  {
+    return;
+  }
+  
+  // the objective value of the subproblem lacks the deviation of the vertices outside it
+  double objValue = ilp.getObjValue() - excludedDeviation;
+  if (_pSolution->size() == 0 || g_tol.less(_objValue, objValue))
+  {
+    _objValue = objValue;
+    _pSolution->clear();
+  }
+  else if (g_tol.less(objValue, _objValue))
+  {
+    return;
+  }
+  
+  for (int idx = 0; idx < solution.size(); ++idx)
+  {
+    if (!_pSolution->present(solution.solution(idx)))
+    {
+      _pSolution->add(solution.solution(idx));
+    }
+  }
+}
+
+void RootDecomposedSolver::runWorker()
+{
+  const int nrSubproblems = _subproblems.size();
+  for (int idx = _next++; idx < nrSubproblems; idx = _next++)
+  {
+    const Subproblem& sub = _subproblems[idx];
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      if (_pSolution->size() > 0 && !g_tol.less(_objValue, sub._bound))
+      {
+        ++_nrPruned;
+        continue;
+      }
+    }
+    
+    solveSubproblem(sub);
+  }
+}
+
+bool RootDecomposedSolver::solve(MaxSolution& solution)
+{
+  const Digraph& G = _G.getG();
+  const int n = _F_interval_clustered.getNrCols();
+  
+  double totalMinDeviation = 0;
+  for (int j = 0; j < n; ++j)
+  {
+    totalMinDeviation += _minDeviation[j];
+  }
+  
+  // a tree rooted at v_j spans at most the vertices reachable from v_j
+  _subproblems.clear();
+  StlBoolVector reached(n);
+  for (int j = 0; j < n; ++j)
+  {
+    if (!_rootCandidate[j])
+    {
+      continue;
+    }
+    
+    Subproblem sub;
+    sub._columns.push_back(j);
+    std::fill(reached.begin(), reached.end(), false);
+    reached[j] = true;
+    for (size_t idx = 0; idx < sub._columns.size(); ++idx)
+    {
+      Node v = _G.mapColumnToNode(sub._columns[idx]);
+      for (OutArcIt a(G, v); a != lemon::INVALID; ++a)
+      {
+        int k = _G.mapNodeToColumn(G.target(a));
+        if (!reached[k])
+        {
+          reached[k] = true;
+          sub._columns.push_back(k);
+        }
+      }
+    }
+    sub._bound = sub._columns.size() - totalMinDeviation;
+    _subproblems.push_back(sub);
+  }
+  std::stable_sort(_subproblems.begin(), _subproblems.end());
+  
+  solution.clear();
+  _pSolution = &solution;
+  _objValue = 0;
+  _optimal = true;
+  _next = 0;
+  _nrSolved = 0;
+  _nrPruned = 0;
+  _timer.restart();
+  
+  std::vector<std::thread> threads;
+  for (int id = 0; id < _nrThreads; ++id)
+  {
+    threads.push_back(std::thread(&RootDecomposedSolver::runWorker, this));
+  }
+  for (int id = 0; id < _nrThreads; ++id)
+  {
+    threads[id].join();
+  }
+  _pSolution = NULL;
+  
+  if (solution.size() == 0)
+  {
+    return false;
+  }
+  
+  std::cerr << "[" << _objValue << ", " << (_optimal ? "optimal" : "time limit")
+            << ", " << _nrSolved << " solved, " << _nrPruned << " pruned]" << std::endl;
+  
+  return true;
+}
+
+} // namespace vaff
@@ -0,0 +1,116 @@
+/*
+ *  rootdecomposedsolver.h
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#ifndef ROOTDECOMPOSEDSOLVER_H
+#define ROOTDECOMPOSEDSOLVER_H
+
+#include "intmaxilpsolver.h"
+#include <lemon/time_measure.h>
+#include <mutex>
+#include <atomic>
+
+namespace vaff {
+
+// solves one single-threaded ILP per root candidate, restricted to the
+// vertices reachable from that root, on a pool of threads; candidates are
+// processed by decreasing bound and skipped once their bound does not
+// exceed the objective value of the incumbent
+class RootDecomposedSolver : public Solver
+{
+public:
+  RootDecomposedSolver(const BaseAncestryGraph& G,
+                       const RealIntervalMatrix& F_interval_clustered,
+                       const RealMatrix& F_point_unclustered,
+                       const StlIntMatrix& toUnclusteredColumn,
+                       int timeLimit,
+                       int nrThreads,
+                       IntMaxIlpSolver::Formulation formulation = IntMaxIlpSolver::PRODUCT_FORMULATION,
+                       const std::string& backend = "");
+  
+  bool solve(MaxSolution& solution);
+  
+  void applyPresolve(const StlBoolVector& rootCandidate,
+                     const RealIntervalMatrix& F_interval_nonroot)
+  {
+    _rootCandidate = rootCandidate;
+    _F_interval_nonroot = F_interval_nonroot;
+  }
+  
+  void setCoverCuts(bool coverCuts)
+  {
+    _coverCuts = coverCuts;
+  }
+  
+  // false if the time limit was hit
+  bool isOptimal() const
+  {
+    return _optimal;
+  }
+  
+  double getObjValue() const
+  {
+    return _objValue;
+  }
+  
+  int getNrSolved() const
+  {
+    return _nrSolved;
+  }
+  
+  int getNrPruned() const
+  {
+    return _nrPruned;
+  }
+
+private:
+  struct Subproblem
+  {
+    // columns of G reachable from the root, the root comes first
+    StlIntVector _columns;
+    // upper bound on the objective value of trees rooted at _columns[0]
+    double _bound;
+    
+    // larger bounds are processed first
+    bool operator<(const Subproblem& other) const
+    {
+      return _bound > other._bound;
+    }
+  };
+  
+  typedef std::vector<Subproblem> SubproblemVector;
+  
+  const int _nrThreads;
+  const IntMaxIlpSolver::Formulation _formulation;
+  const std::string _backend;
+  bool _coverCuts;
+  StlBoolVector _rootCandidate;
+  RealIntervalMatrix _F_interval_nonroot;
+  // _minDeviation[j] : smallest VAF deviation of v_j, attained by any f
+  // within the column bounds of v_j whether it is in the tree or not
+  StlDoubleVector _minDeviation;
+  
+  SubproblemVector _subproblems;
+  std::atomic<int> _next;
+  std::atomic<int> _nrSolved;
+  std::atomic<int> _nrPruned;
+  
+  // guards the incumbent
+  std::mutex _mutex;
+  MaxSolution* _pSolution;
+  double _objValue;
+  bool _optimal;
+  
+  lemon::Timer _timer;
+  
+  void runWorker();
+  
+  void solveSubproblem(const Subproblem& sub);
+};
+
+} // namespace vaff
+
+#endif // ROOTDECOMPOSEDSOLVER_H
@@ -0,0 +1,226 @@
+/*
+ *  samplerefinementsolver.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "samplerefinementsolver.h"
+
+namespace vaff {
+
+SampleRefinementSolver::SampleRefinementSolver(const BaseAncestryGraph& G,
+                                               const RealIntervalMatrix& F_interval_clustered,
+                                               const RealMatrix& F_point_unclustered,
+                                               const StlIntMatrix& toUnclusteredColumn,
+                                               int timeLimit,
+                                               int nrInitialSamples,
+                                               IntMaxIlpSolver::Formulation formulation,
+                                               const std::string& backend)
+  : Solver(G, F_interval_clustered, F_point_unclustered, toUnclusteredColumn, timeLimit)
+  , _nrInitialSamples(nrInitialSamples)
+  , _formulation(formulation)
+  , _backend(backend)
+  , _rootCandidate(F_interval_clustered.getNrCols(), true)
+  , _F_interval_nonroot(F_interval_clustered)
+  , _timer()
+  , _optimal(false)
+  , _objValue(0)
+  , _nrSamples(0)
+{
+}
+
+bool SampleRefinementSolver::solveSubset(const StlIntVector& samples,
+                                         const StlIntVector& parent,
+                                         MaxSolution& solution,
+                                         double& objValue,
+                                         int& bound)
+{
+  const int m = samples.size();
+  const int n = _F_interval_clustered.getNrCols();
+  const int org_n = _F_point_unclustered.getNrCols();
+  
+  int timeLimit = -1;
+  if (_timeLimit > 0)
+  {
+    timeLimit = _timeLimit - static_cast<int>(_timer.realTime());
+    if (timeLimit <= 0)
+    {
+      return false;
+    }
+  }
+  
+  RealIntervalMatrix CI(m, n);
+  RealIntervalMatrix CI_nonroot(m, n);
+  RealMatrix F(m, org_n);
+  for (int k = 0; k < m; ++k)
+  {
+    int i = samples[k];
+    for (int j = 0; j < n; ++j)
+    {
+      CI.set(k, j, _F_interval_clustered(i, j));
+      CI_nonroot.set(k, j, _F_interval_nonroot(i, j));
+    }
+    for (int j = 0; j < org_n; ++j)
+    {
+      F.set(k, j, _F_point_unclustered(i, j));
+    }
+    F.setRowLabel(k, _F_point_unclustered.getRowLabel(i));
+  }
+  
+  IntMaxIlpSolver ilp(_G,
+                      CI,
+                      F,
+                      _toUnclusteredColumn,
+                      timeLimit,
+                      _formulation,
+                      _backend);
+  ilp.applyPresolve(_rootCandidate, CI_nonroot);
+  if (!parent.empty())
+  {
+    ilp.setMipStart(parent);
+  }
+  
+  if (!ilp.solve(solution))
+  {
+    return false;
+  }
+  
+  // the VAF deviation is at most 0.5
+  objValue = ilp.getObjValue();
+  bound = static_cast<int>(floor(ilp.getBestObjValue() + 0.5 + 1e-6));
+  return true;
+}
+
+bool SampleRefinementSolver::solveTree(const StlIntVector& parent,
+                                       MaxSolution& solution,
+                                       double& objValue)
+{
+  int timeLimit = -1;
+  if (_timeLimit > 0)
+  {
+    timeLimit = _timeLimit - static_cast<int>(_timer.realTime());
+    if (timeLimit <= 0)
+    {
+      return false;
+    }
+  }
+  
+  // the tree is the only one of its size in T
+  BaseAncestryGraph T;
+  _G.restrict(parent, T);
+  
+  IntMaxIlpSolver ilp(T,
+                      _F_interval_clustered,
+                      _F_point_unclustered,
+                      _toUnclusteredColumn,
+                      timeLimit,
+                      _formulation,
+                      _backend);
+  ilp.setMipStart(parent);
+  
+  if (!ilp.solve(solution))
+  {
+    return false;
+  }
+  
+  objValue = ilp.getObjValue();
+  return true;
+}
+
+bool SampleRefinementSolver::solve(MaxSolution& solution)
+{
+  const int m = _F_interval_clustered.getNrRows();
+  
+  _timer.restart();
+  _optimal = false;
+  
+  StlIntVector order;
+  sampleOrder(order);
+  
+  StlIntVector bestParent;
+  int bestSize = 0;
+  int nrSamples = std::max(1, std::min(m, _nrInitialSamples));
+  while (true)
+  {
+    StlIntVector samples(order.begin(), order.begin() + nrSamples);
+    MaxSolution subSolution;
+    double objValue = 0;
+    int bound = 0;
+    if (!solveSubset(samples, bestParent, subSolution, objValue, bound))
+    {
+      break;
+    }
+    _nrSamples = nrSamples;
+    
+    if (nrSamples == m)
+    {
+      // the full model was solved, starting from the best tree found so far
+      solution.clear();
+      for (int idx = 0; idx < subSolution.size(); ++idx)
+      {
+        solution.add(subSolution.solution(idx));
+      }
+      _objValue = objValue;
+      _optimal = bound == subSolution.solution(0)._F.getNrCols();
+      std::cerr << "[" << _objValue << ", " << (_optimal ? "optimal" : "time limit")
+                << ", " << m << " of " << m << " samples]" << std::endl;
+      return true;
+    }
+    
+    // trees that are feasible for all samples
+    for (int idx = 0; idx < subSolution.size(); ++idx)
+    {
+      StlIntVector parent;
+      if (mapSolution(subSolution.solution(idx), parent))
+      {
+        int size = parent.size() - std::count(parent.begin(), parent.end(), -2);
+        if (size > bestSize)
+        {
+          bestSize = size;
+          bestParent = parent;
+        }
+      }
+    }
+    
+    std::cerr << "Samples: " << nrSamples << " of " << m << ", bound: " << bound
+              << ", feasible tree: " << bestSize << std::endl;
+    
+    if (bestSize >= bound)
+    {
+      _optimal = true;
+      break;
+    }
+    
+    nrSamples = std::min(m, 2 * nrSamples);
+  }
+  
+  if (bestSize == 0)
+  {
+    return false;
+  }
+  
+  // greedy frequencies if the time is up
+  if (!solveTree(bestParent, solution, _objValue))
+  {
+    StlDoubleMatrix f;
+    if (!computeFrequencies(bestParent, f))
+    {
+      return false;
+    }
+    
+    MaxSolution::Triple sol;
+    constructSolution(bestParent, f, sol);
+    solution.clear();
+    solution.add(sol);
+    
+    _objValue = bestSize - deviation(f);
+  }
+  
+  std::cerr << "[" << _objValue << ", " << (_optimal ? "size-optimal" : "time limit")
+            << ", " << _nrSamples << " of " << m << " samples]" << std::endl;
+  
+  return true;
+}
+
+} // namespace vaff
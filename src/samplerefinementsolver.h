@@ -0,0 +1,90 @@
+/*
+ *  samplerefinementsolver.h
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#ifndef SAMPLEREFINEMENTSOLVER_H
+#define SAMPLEREFINEMENTSOLVER_H
+
+#include "intmaxilpsolver.h"
+#include <lemon/time_measure.h>
+
+namespace vaff {
+
+// solves the ILP on a growing subset of the samples, ordered by decreasing
+// VAF spread; dropping samples relaxes the sum rule, so the optimal tree
+// size on a subset bounds the one on all samples; the subset is doubled
+// until the largest tree that is feasible for all samples attains the
+// bound. That tree has optimal size, its frequencies minimize the VAF
+// deviation of that tree only, not over all trees of the same size
+class SampleRefinementSolver : public Solver
+{
+public:
+  SampleRefinementSolver(const BaseAncestryGraph& G,
+                         const RealIntervalMatrix& F_interval_clustered,
+                         const RealMatrix& F_point_unclustered,
+                         const StlIntMatrix& toUnclusteredColumn,
+                         int timeLimit,
+                         int nrInitialSamples,
+                         IntMaxIlpSolver::Formulation formulation = IntMaxIlpSolver::PRODUCT_FORMULATION,
+                         const std::string& backend = "");
+  
+  bool solve(MaxSolution& solution);
+  
+  void applyPresolve(const StlBoolVector& rootCandidate,
+                     const RealIntervalMatrix& F_interval_nonroot)
+  {
+    _rootCandidate = rootCandidate;
+    _F_interval_nonroot = F_interval_nonroot;
+  }
+  
+  // false if neither a subset bound nor the full model proved optimality,
+  // a subset bound only proves that the tree size is optimal
+  bool isOptimal() const
+  {
+    return _optimal;
+  }
+  
+  double getObjValue() const
+  {
+    return _objValue;
+  }
+  
+  // number of samples of the last model that was solved
+  int getNrSamples() const
+  {
+    return _nrSamples;
+  }
+
+private:
+  const int _nrInitialSamples;
+  const IntMaxIlpSolver::Formulation _formulation;
+  const std::string _backend;
+  StlBoolVector _rootCandidate;
+  RealIntervalMatrix _F_interval_nonroot;
+  
+  lemon::Timer _timer;
+  bool _optimal;
+  double _objValue;
+  int _nrSamples;
+  
+  // solves the model restricted to samples, starting from parent if it is
+  // non-empty; bound is set to an upper bound on the tree size
+  bool solveSubset(const StlIntVector& samples,
+                   const StlIntVector& parent,
+                   MaxSolution& solution,
+                   double& objValue,
+                   int& bound);
+  
+  // solves the model on all samples restricted to the arcs of parent, which
+  // sets frequencies of that tree that minimize the VAF deviation
+  bool solveTree(const StlIntVector& parent,
+                 MaxSolution& solution,
+                 double& objValue);
+};
+
+} // namespace vaff
+
+#endif // SAMPLEREFINEMENTSOLVER_H
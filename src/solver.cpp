@@ -6,16 +6,473 @@
  */
 
 #include "solver.h"
+#include <lemon/adaptors.h>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
 
 namespace vaff {
 
-Solver::Solver(const RealMatrix& F)
-  : _F(F)
+Solver::Solver(const BaseAncestryGraph& G,
+               const RealIntervalMatrix& F_interval_clustered,
+               const RealMatrix& F_point_unclustered,
+               const StlIntMatrix& toUnclusteredColumn,
+               int timeLimit)
+  : _G(G)
+  , _F_interval_clustered(F_interval_clustered)
+  , _F_point_unclustered(F_point_unclustered)
+  , _toUnclusteredColumn(toUnclusteredColumn)
+  , _timeLimit(timeLimit)
 {
+  assert(F_interval_clustered.getNrRows() == F_point_unclustered.getNrRows());
+  assert(F_interval_clustered.getNrCols() <= F_point_unclustered.getNrCols());
 }
 
 Solver::~Solver()
 {
 }
+  
+bool Solver::mapSolution(const MaxSolution::Triple& sol,
+                         StlIntVector& parent) const
+{
+  typedef std::vector<std::string> StringVector;
+  typedef StringVector::const_iterator StringVectorIt;
+  typedef ClonalTree::Tree Tree;
+  
+  const Digraph& G = _G.getG();
+  const int n = _F_interval_clustered.getNrCols();
+  const int org_n = _F_point_unclustered.getNrCols();
+  const int sol_n = sol._F.getNrCols();
+  
+  StlIntVector toColumn(org_n, -1);
+  for (int j = 0; j < n; ++j)
+  {
+    const StlIntVector& M = _toUnclusteredColumn[j];
+    for (StlIntVectorIt it = M.begin(); it != M.end(); ++it)
+    {
+      toColumn[*it] = j;
+    }
+  }
+  
+  // column labels of the solution list the unclustered mutations
+  StlIntVector solToColumn(sol_n, -1);
+  StlIntVector count(n, 0);
+  for (int k = 0; k < sol_n; ++k)
+  {
+    StringVector s;
+    boost::split(s, sol._F.getColLabel(k), boost::is_any_of(";"));
+    
+    std::fill(count.begin(), count.end(), 0);
+    int bestCount = 0;
+    for (StringVectorIt it = s.begin(); it != s.end(); ++it)
+    {
+      if (*it == "")
+      {
+        continue;
+      }
+      
+      int org_j = boost::lexical_cast<int>(*it);
+      if (0 <= org_j && org_j < org_n && toColumn[org_j] != -1)
+      {
+        int j = toColumn[org_j];
+        if (++count[j] > bestCount)
+        {
+          bestCount = count[j];
+          solToColumn[k] = j;
+        }
+      }
+    }
+  }
+  
+  // image[v] : column of the nearest mapped vertex on the path from the root to v
+  const Tree& T = sol._T.getT();
+  Tree::NodeMap<int> image(T, -1);
+  
+  parent = StlIntVector(n, -2);
+  StlDoubleMatrix f;
+  
+  std::vector<Tree::Node> queue(1, sol._T.getRoot());
+  for (size_t idx = 0; idx < queue.size(); ++idx)
+  {
+    Tree::Node v = queue[idx];
+    for (Tree::OutArcIt a(T, v); a != lemon::INVALID; ++a)
+    {
+      queue.push_back(T.target(a));
+    }
+    
+    Tree::Node u = sol._T.getParent(v);
+    int anc = u == lemon::INVALID ? -1 : image[u];
+    int j = solToColumn[sol._T.nodeToMutation(v)];
+    image[v] = anc;
+    
+    if (j == -1 || parent[j] != -2)
+    {
+      continue;
+    }
+    
+    if (u == lemon::INVALID)
+    {
+      parent[j] = -1;
+    }
+    else if (anc != -1
+             && lemon::findArc(G, _G.mapColumnToNode(anc), _G.mapColumnToNode(j)) != lemon::INVALID)
+    {
+      parent[j] = anc;
+    }
+    else
+    {
+      continue;
+    }
+    
+    if (computeFrequencies(parent, f))
+    {
+      image[v] = j;
+    }
+    else
+    {
+      parent[j] = -2;
+    }
+  }
+  
+  return std::find(parent.begin(), parent.end(), -1) != parent.end();
+}
+
+double Solver::target(int i, int j) const
+{
+  // the median of the truncated point estimates minimizes the VAF deviation
+  const StlIntVector& M = _toUnclusteredColumn[j];
+  StlDoubleVector values;
+  for (StlIntVectorIt it = M.begin(); it != M.end(); ++it)
+  {
+    values.push_back(std::min(0.5, _F_point_unclustered(i, *it)));
+  }
+  
+  if (values.empty())
+  {
+    return 0;
+  }
+  
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+double Solver::deviation(const StlDoubleMatrix& f) const
+{
+  const int m = _F_point_unclustered.getNrRows();
+  const int n = _F_interval_clustered.getNrCols();
+  const int org_n = _F_point_unclustered.getNrCols();
+  const double frac = 1.0 / (m * org_n);
+  
+  double res = 0;
+  for (int i = 0; i < m; ++i)
+  {
+    for (int j = 0; j < n; ++j)
+    {
+      const StlIntVector& M = _toUnclusteredColumn[j];
+      for (StlIntVectorIt it = M.begin(); it != M.end(); ++it)
+      {
+        res += frac * fabs(std::min(0.5, _F_point_unclustered(i, *it)) - f[i][j]);
+      }
+    }
+  }
+  
+  return res;
+}
+
+double Solver::minDeviation(int j,
+                            const RealIntervalMatrix& F_interval_clustered,
+                            const RealMatrix& F_point_unclustered,
+                            const StlIntMatrix& toUnclusteredColumn)
+{
+  const int m = F_interval_clustered.getNrRows();
+  const int org_n = F_point_unclustered.getNrCols();
+  const double frac = 1.0 / (m * org_n);
+  
+  double res = 0;
+  const StlIntVector& M = toUnclusteredColumn[j];
+  for (int i = 0; i < m; ++i)
+  {
+    double ub = std::min(0.5, F_interval_clustered(i, j).second);
+    double lb = std::min(F_interval_clustered(i, j).first, ub);
+    for (StlIntVectorIt it = M.begin(); it != M.end(); ++it)
+    {
+      double f = std::min(0.5, F_point_unclustered(i, *it));
+      res += frac * std::max(0.0, std::max(lb - f, f - ub));
+    }
+  }
+  
+  return res;
+}
+
+void Solver::sampleOrder(StlIntVector& order) const
+{
+  typedef std::pair<double, int> DoubleIntPair;
+  typedef std::vector<DoubleIntPair> DoubleIntPairVector;
+  
+  const int m = _F_point_unclustered.getNrRows();
+  const int org_n = _F_point_unclustered.getNrCols();
+  
+  DoubleIntPairVector spread;
+  for (int i = 0; i < m; ++i)
+  {
+    double min_f = 0.5;
+    double max_f = 0;
+    for (int j = 0; j < org_n; ++j)
+    {
+      double f = std::min(0.5, _F_point_unclustered(i, j));
+      min_f = std::min(min_f, f);
+      max_f = std::max(max_f, f);
+    }
+    spread.push_back(DoubleIntPair(min_f - max_f, i));
+  }
+  std::stable_sort(spread.begin(), spread.end());
+  
+  order.clear();
+  for (DoubleIntPairVector::const_iterator it = spread.begin(); it != spread.end(); ++it)
+  {
+    order.push_back(it->second);
+  }
+}
+
+void Solver::topologicalOrder(StlIntVector& order) const
+{
+  const Digraph& G = _G.getG();
+  const int n = _F_interval_clustered.getNrCols();
+  
+  StlIntMatrix out(n);
+  StlIntVector inDegree(n, 0);
+  for (ArcIt a(G); a != lemon::INVALID; ++a)
+  {
+    int j = _G.mapNodeToColumn(G.source(a));
+    int k = _G.mapNodeToColumn(G.target(a));
+    out[j].push_back(k);
+    ++inDegree[k];
+  }
+  
+  order.clear();
+  for (int j = 0; j < n; ++j)
+  {
+    if (inDegree[j] == 0)
+    {
+      order.push_back(j);
+    }
+  }
+  for (size_t idx = 0; idx < order.size(); ++idx)
+  {
+    const StlIntVector& K = out[order[idx]];
+    for (StlIntVectorIt it = K.begin(); it != K.end(); ++it)
+    {
+      if (--inDegree[*it] == 0)
+      {
+        order.push_back(*it);
+      }
+    }
+  }
+  assert(order.size() == n);
+}
+
+bool Solver::computeFrequencies(const StlIntVector& parent,
+                                StlDoubleMatrix& f) const
+{
+  const int m = _F_interval_clustered.getNrRows();
+  const int n = _F_interval_clustered.getNrCols();
+  
+  StlIntMatrix children(n);
+  int root = -1;
+  for (int j = 0; j < n; ++j)
+  {
+    if (parent[j] == -1)
+    {
+      root = j;
+    }
+    else if (parent[j] >= 0)
+    {
+      children[parent[j]].push_back(j);
+    }
+  }
+  
+  if (root == -1)
+  {
+    return false;
+  }
+  
+  // pre-order of the tree
+  StlIntVector order(1, root);
+  for (size_t idx = 0; idx < order.size(); ++idx)
+  {
+    const StlIntVector& C = children[order[idx]];
+    order.insert(order.end(), C.begin(), C.end());
+  }
+  
+  f = StlDoubleMatrix(m, StlDoubleVector(n, 0));
+  StlDoubleVector need(n, 0);
+  for (int i = 0; i < m; ++i)
+  {
+    // need[j] : smallest f[i][j] that accommodates the subtree of v_j
+    for (StlIntVector::const_reverse_iterator it = order.rbegin(); it != order.rend(); ++it)
+    {
+      int j = *it;
+      double sum = 0;
+      for (StlIntVectorIt it2 = children[j].begin(); it2 != children[j].end(); ++it2)
+      {
+        sum += need[*it2];
+      }
+      need[j] = std::max(_F_interval_clustered(i, j).first, sum);
+      if (g_tol.less(std::min(0.5, _F_interval_clustered(i, j).second), need[j]))
+      {
+        return false;
+      }
+    }
+    
+    // move every node towards its target, handing the remaining slack down;
+    // the lower bound is clamped as in the ILP, so clusters with a lower
+    // bound above 0.5, which are never in the tree, stay within bounds
+    for (int j = 0; j < n; ++j)
+    {
+      const RealInterval& interval = _F_interval_clustered(i, j);
+      double ub = std::min(0.5, interval.second);
+      f[i][j] = std::max(std::min(interval.first, ub),
+                         std::min(ub, target(i, j)));
+    }
+    f[i][root] = std::max(need[root], f[i][root]);
+    
+    for (StlIntVectorIt it = order.begin(); it != order.end(); ++it)
+    {
+      int j = *it;
+      double slack = f[i][j];
+      for (StlIntVectorIt it2 = children[j].begin(); it2 != children[j].end(); ++it2)
+      {
+        slack -= need[*it2];
+      }
+      
+      for (StlIntVectorIt it2 = children[j].begin(); it2 != children[j].end(); ++it2)
+      {
+        int k = *it2;
+        double ub = std::min(std::min(0.5, _F_interval_clustered(i, k).second),
+                             need[k] + std::max(0.0, slack));
+        f[i][k] = std::max(need[k], std::min(ub, target(i, k)));
+        slack -= f[i][k] - need[k];
+      }
+    }
+  }
+  
+  return true;
+}
+
+void Solver::constructSolution(const StlIntVector& parent,
+                               const StlDoubleMatrix& f,
+                               MaxSolution::Triple& sol) const
+{
+  const Digraph& G = _G.getG();
+  
+  StlIntVector mutationSolVec;
+  IntNodeMap mutationSolMap(G, -1);
+  BoolNodeMap mutationSolMap2(G, false);
+  
+  // root first, then in arc order
+  for (NodeIt v(G); v != lemon::INVALID; ++v)
+  {
+    if (parent[_G.mapNodeToColumn(v)] == -1)
+    {
+      mutationSolMap[v] = mutationSolVec.size();
+      mutationSolVec.push_back(_G.mapNodeToColumn(v));
+      mutationSolMap2[v] = true;
+    }
+  }
+  
+  BoolArcMap arcSolMap(G, false);
+  for (ArcIt a(G); a != lemon::INVALID; ++a)
+  {
+    Node u = G.source(a);
+    Node v = G.target(a);
+    bool val = parent[_G.mapNodeToColumn(v)] == _G.mapNodeToColumn(u);
+    arcSolMap[a] = val;
+    
+    if (val)
+    {
+      if (mutationSolMap[u] == -1)
+      {
+        mutationSolMap[u] = mutationSolVec.size();
+        mutationSolVec.push_back(_G.mapNodeToColumn(u));
+        mutationSolMap2[u] = true;
+      }
+      
+      if (mutationSolMap[v] == -1)
+      {
+        mutationSolMap[v] = mutationSolVec.size();
+        mutationSolVec.push_back(_G.mapNodeToColumn(v));
+        mutationSolMap2[v] = true;
+      }
+    }
+  }
+  
+  const int m = _F_interval_clustered.getNrRows();
+  const int n = mutationSolVec.size();
+  
+  typedef lemon::SubDigraph<const Digraph> SubDigraph;
+  SubDigraph subG(G, mutationSolMap2, arcSolMap);
+  
+  for (SubDigraph::NodeIt v_j(subG); v_j != lemon::INVALID; ++v_j)
+  {
+    int j = _G.mapNodeToColumn(v_j);
+    for (int i = 0; i < m; ++i)
+    {
+      const RealInterval& interval_ij = _F_interval_clustered(i,j);
+      double f_ij = f[i][j];
+      assert(!g_tol.less(f_ij, interval_ij.first) && !g_tol.less(interval_ij.second, f_ij));
+      double sum = 0;
+      for (SubDigraph::OutArcIt a_jk(subG, v_j); a_jk != lemon::INVALID; ++a_jk)
+      {
+        int k = _G.mapNodeToColumn(G.target(a_jk));
+        double f_ik = f[i][k];
+        const RealInterval& interval = _F_interval_clustered(i,k);
+        assert(!g_tol.less(f_ik, interval.first) && !g_tol.less(interval.second, f_ik));
+        sum += f_ik;
+      }
+      assert(!g_tol.less(f_ij, sum));
+    }
+  }
+  
+  sol._T = ClonalTree(subG, mutationSolMap, _G.getProbMap());
+  
+  sol._F = RealMatrix(m, n);
+  for (int i = 0; i < m; ++i)
+  {
+    sol._F.setRowLabel(i, _F_point_unclustered.getRowLabel(i));
+    for (int j = 0; j < n; ++j)
+    {
+      double f_ij = f[i][mutationSolVec[j]];
+      if (!g_tol.nonZero(f_ij))
+      {
+        f_ij = 0;
+      }
+      sol._F.set(i, j, f_ij);
+    }
+  }
+  
+  char buf[1024];
+  for (int j = 0; j < n; ++j)
+  {
+    const StlIntVector& M = _toUnclusteredColumn[mutationSolVec[j]];
+    std::string label;
+    bool first = true;
+    for (StlIntVectorIt it = M.begin(); it != M.end(); ++it)
+    {
+      if (first)
+      {
+        first = false;
+      }
+      else
+      {
+        label += ";";
+      }
+      snprintf(buf, 1024, "%d", *it);
+      label += buf;
+    }
+    
+    sol._F.setColLabel(j, label);
+  }
+  
+  sol._U = sol._T.getU(sol._F);
+}
 
 } // namespace vaff
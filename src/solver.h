@@ -9,27 +9,71 @@
 #define SOLVER_H
 
 #include "utils.h"
-#include "solution.h"
+#include "baseancestrygraph.h"
+#include "realintervalmatrix.h"
+#include "maxsolution.h"
 
 namespace vaff {
 
 class Solver
 {
 public:
-  Solver(const RealMatrix& V);
+  typedef BaseAncestryGraph::Digraph Digraph;
+  DIGRAPH_TYPEDEFS(Digraph);
+  
+  Solver(const BaseAncestryGraph& G,
+         const RealIntervalMatrix& F_interval_clustered,
+         const RealMatrix& F_point_unclustered,
+         const StlIntMatrix& toUnclusteredColumn,
+         int timeLimit);
   
   virtual ~Solver();
   
-  virtual bool solve(Solution& solution) = 0;
+  virtual bool solve(MaxSolution& solution) = 0;
   
-protected:
-  const RealMatrix& _F;
-};
+  // maps the tree of a solution for the same mutations, possibly obtained
+  // with other parameters, onto G: every tree vertex is identified with the
+  // column of G holding most of its mutations and attached to its nearest
+  // mapped ancestor, vertices that violate G or the sum rule are skipped;
+  // returns false if the root could not be mapped
+  bool mapSolution(const MaxSolution::Triple& sol,
+                   StlIntVector& parent) const;
   
-} // namespace vaff
+  // smallest VAF deviation penalty of cluster j in any tree, with f
+  // restricted to the column bounds [min(lb, ub), ub] of the ILP
+  static double minDeviation(int j,
+                             const RealIntervalMatrix& F_interval_clustered,
+                             const RealMatrix& F_point_unclustered,
+                             const StlIntMatrix& toUnclusteredColumn);
 
-#endif // SOLVER_H
+protected:
+  const BaseAncestryGraph& _G;
+  const RealIntervalMatrix& _F_interval_clustered;
+  const RealMatrix& _F_point_unclustered;
+  const StlIntMatrix& _toUnclusteredColumn;
+  const int _timeLimit;
 
+  // parent[j] : column of the parent of v_j, -1 if v_j is the root
+  // and -2 if v_j is not in the tree
+  bool computeFrequencies(const StlIntVector& parent,
+                          StlDoubleMatrix& f) const;
 
+  void constructSolution(const StlIntVector& parent,
+                         const StlDoubleMatrix& f,
+                         MaxSolution::Triple& sol) const;
 
+  // VAF deviation penalty of the objective, at most 0.5
+  double deviation(const StlDoubleMatrix& f) const;
 
+  double target(int i, int j) const;
+  
+  // columns of G in topological order
+  void topologicalOrder(StlIntVector& order) const;
+  
+  // samples by decreasing VAF spread, the most likely to be binding first
+  void sampleOrder(StlIntVector& order) const;
+};
+
+} // namespace vaff
+
+#endif // SOLVER_H
@@ -0,0 +1,493 @@
+/*
+ *  subsetdpsolver.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "subsetdpsolver.h"
+
+namespace vaff {
+
+// bounds the memory used by the fronts
+static const size_t MAX_STATES = 1 << 21;
+
+SubsetDpSolver::SubsetDpSolver(const BaseAncestryGraph& G,
+                               const RealIntervalMatrix& F_interval_clustered,
+                               const RealMatrix& F_point_unclustered,
+                               const StlIntMatrix& toUnclusteredColumn,
+                               int timeLimit)
+  : Solver(G, F_interval_clustered, F_point_unclustered, toUnclusteredColumn, timeLimit)
+  , _n(F_interval_clustered.getNrCols())
+  , _m(F_interval_clustered.getNrRows())
+  , _order()
+  , _children(_n, 0)
+  , _parents(_n, 0)
+  , _ancestors(_n, 0)
+  , _descendants(_n, 0)
+  , _rootCandidate(_n, true)
+  , _lb(_n)
+  , _ub(_n)
+  , _fronts()
+  , _frontIndex()
+  , _timer()
+  , _objValue(0)
+{
+  assert(_G.isDAG());
+  assert(_n <= MAX_NODES);
+  
+  const Digraph& g = _G.getG();
+  
+  // topological order, the first vertex of a subset in this order
+  // has no ancestors in that subset
+  topologicalOrder(_order);
+  
+  StlIntMatrix out(_n);
+  for (ArcIt a(g); a != lemon::INVALID; ++a)
+  {
+    out[_G.mapNodeToColumn(g.source(a))].push_back(_G.mapNodeToColumn(g.target(a)));
+  }
+  
+  StlIntVector position(_n, -1);
+  for (int p = 0; p < _n; ++p)
+  {
+    position[_order[p]] = p;
+  }
+  
+  for (int p = _n - 1; p >= 0; --p)
+  {
+    const StlIntVector& K = out[_order[p]];
+    for (StlIntVectorIt it = K.begin(); it != K.end(); ++it)
+    {
+      int q = position[*it];
+      _children[p] |= Mask(1) << q;
+      _parents[q] |= Mask(1) << p;
+      _descendants[p] |= (Mask(1) << q) | _descendants[q];
+    }
+    
+    _lb[p] = StlDoubleVector(_m, 0);
+    _ub[p] = StlDoubleVector(_m, 0);
+    for (int i = 0; i < _m; ++i)
+    {
+      _lb[p][i] = _F_interval_clustered(i, _order[p]).first;
+      _ub[p][i] = std::min(0.5, _F_interval_clustered(i, _order[p]).second);
+    }
+  }
+  
+  for (int q = 0; q < _n; ++q)
+  {
+    for (int p = 0; p < q; ++p)
+    {
+      if (_parents[q] & (Mask(1) << p))
+      {
+        _ancestors[q] |= (Mask(1) << p) | _ancestors[p];
+      }
+    }
+  }
+}
+
+bool SubsetDpSolver::addEntry(Front& front, const Entry& entry) const
+{
+  for (Front::const_iterator it = front.begin(); it != front.end(); ++it)
+  {
+    bool dominated = true;
+    for (int i = 0; i < _m && dominated; ++i)
+    {
+      dominated = !g_tol.less(entry._need[i], it->_need[i]);
+    }
+    if (dominated)
+    {
+      return false;
+    }
+  }
+  
+  for (int idx = front.size() - 1; idx >= 0; --idx)
+  {
+    bool dominates = true;
+    for (int i = 0; i < _m && dominates; ++i)
+    {
+      dominates = !g_tol.less(front[idx]._need[i], entry._need[i]);
+    }
+    if (dominates)
+    {
+      front[idx] = front.back();
+      front.pop_back();
+    }
+  }
+  
+  front.push_back(entry);
+  return true;
+}
+
+bool SubsetDpSolver::canSpan(int p, Mask R) const
+{
+  // every vertex needs a parent, the first vertices are children of v_p and
+  // both the first and the last vertices form antichains whose frequencies
+  // add up to at most f[i][p]
+  Mask first = 0;
+  Mask last = 0;
+  for (Mask Q = R; Q != 0; Q &= Q - 1)
+  {
+    int q = lowest(Q);
+    Mask bit = Mask(1) << q;
+    if (!(_parents[q] & (R | (Mask(1) << p))))
+    {
+      return false;
+    }
+    if (!(_ancestors[q] & R))
+    {
+      if (!(_children[p] & bit))
+      {
+        return false;
+      }
+      first |= bit;
+    }
+    if (!(_descendants[q] & R))
+    {
+      last |= bit;
+    }
+  }
+  
+  for (int i = 0; i < _m; ++i)
+  {
+    double sumFirst = 0;
+    double sumLast = 0;
+    for (int q = 0; q < _n; ++q)
+    {
+      if (first & (Mask(1) << q))
+      {
+        sumFirst += _lb[q][i];
+      }
+      if (last & (Mask(1) << q))
+      {
+        sumLast += _lb[q][i];
+      }
+    }
+    if (g_tol.less(_ub[p][i], std::max(sumFirst, sumLast)))
+    {
+      return false;
+    }
+  }
+  
+  return true;
+}
+
+int SubsetDpSolver::store(uint64_t k, const Front& front)
+{
+  int idx = EMPTY_FRONT;
+  if (!front.empty())
+  {
+    idx = _fronts.size();
+    _fronts.push_back(front);
+  }
+  _frontIndex[k] = idx;
+  
+  return idx;
+}
+
+int SubsetDpSolver::tree(int p, Mask S)
+{
+  assert(S & (Mask(1) << p));
+  
+  uint64_t k = key(p, true, S);
+  FrontIndexMap::const_iterator it = _frontIndex.find(k);
+  if (it != _frontIndex.end())
+  {
+    return it->second;
+  }
+  
+  int fi = forest(p, S & ~(Mask(1) << p));
+  if (fi == ABORTED)
+  {
+    return ABORTED;
+  }
+  
+  Front front;
+  Entry entry;
+  entry._part = S;
+  entry._second = -1;
+  for (int idx = 0; idx < _fronts[fi].size(); ++idx)
+  {
+    entry._need = _fronts[fi][idx]._need;
+    entry._first = idx;
+    
+    bool feasible = true;
+    for (int i = 0; i < _m && feasible; ++i)
+    {
+      entry._need[i] = std::max(_lb[p][i], entry._need[i]);
+      feasible = !g_tol.less(_ub[p][i], entry._need[i]);
+    }
+    if (feasible)
+    {
+      addEntry(front, entry);
+    }
+  }
+  
+  return store(k, front);
+}
+
+int SubsetDpSolver::forest(int p, Mask R)
+{
+  if (R == 0)
+  {
+    return ZERO_FRONT;
+  }
+  
+  uint64_t k = key(p, false, R);
+  FrontIndexMap::const_iterator it = _frontIndex.find(k);
+  if (it != _frontIndex.end())
+  {
+    return it->second;
+  }
+  
+  // infeasible sets that are cheap to recognize are not stored
+  if (!canSpan(p, R))
+  {
+    return EMPTY_FRONT;
+  }
+  
+  if (_frontIndex.size() >= MAX_STATES)
+  {
+    return ABORTED;
+  }
+  if ((_frontIndex.size() & 1023) == 0 && _timeLimit > 0 && _timer.realTime() > _timeLimit)
+  {
+    return ABORTED;
+  }
+  
+  Front front;
+  
+  // the first vertex u of R has no ancestor in R, so it is a child of v_p
+  // whose subtree T is a subset of its descendants in R
+  int u = lowest(R);
+  if (_children[p] & (Mask(1) << u))
+  {
+    Mask candidates = R & _descendants[u];
+    Mask sub = candidates;
+    Entry entry;
+    while (true)
+    {
+      Mask T = sub | (Mask(1) << u);
+      int ti = tree(u, T);
+      if (ti == ABORTED)
+      {
+        return ABORTED;
+      }
+      
+      int ri = ti == EMPTY_FRONT ? EMPTY_FRONT : forest(p, R & ~T);
+      if (ri == ABORTED)
+      {
+        return ABORTED;
+      }
+      
+      const Front& subtrees = _fronts[ti];
+      const Front& forests = _fronts[ri];
+      entry._part = T;
+      for (int a = 0; a < subtrees.size(); ++a)
+      {
+        for (int b = 0; b < forests.size(); ++b)
+        {
+          entry._need = subtrees[a]._need;
+          entry._first = a;
+          entry._second = b;
+          
+          // v_p needs at least the sum of its children
+          bool feasible = true;
+          for (int i = 0; i < _m && feasible; ++i)
+          {
+            entry._need[i] += forests[b]._need[i];
+            feasible = !g_tol.less(_ub[p][i], entry._need[i]);
+          }
+          if (feasible)
+          {
+            addEntry(front, entry);
+          }
+        }
+      }
+      
+      if (sub == 0)
+      {
+        break;
+      }
+      sub = (sub - 1) & candidates;
+    }
+  }
+  
+  return store(k, front);
+}
+
+void SubsetDpSolver::reconstructTree(int p,
+                                     Mask S,
+                                     int idx,
+                                     StlIntVector& parent) const
+{
+  const Front& front = _fronts[_frontIndex.find(key(p, true, S))->second];
+  reconstructForest(p, S & ~(Mask(1) << p), front[idx]._first, parent);
+}
+
+void SubsetDpSolver::reconstructForest(int p,
+                                       Mask R,
+                                       int idx,
+                                       StlIntVector& parent) const
+{
+  if (R == 0)
+  {
+    return;
+  }
+  
+  const Front& front = _fronts[_frontIndex.find(key(p, false, R))->second];
+  const Entry& entry = front[idx];
+  
+  int u = lowest(entry._part);
+  parent[_order[u]] = _order[p];
+  reconstructTree(u, entry._part, entry._first, parent);
+  reconstructForest(p, R & ~entry._part, entry._second, parent);
+}
+
+bool SubsetDpSolver::solve(MaxSolution& solution)
+{
+  _timer.restart();
+  
+  _fronts = FrontVector(2);
+  _frontIndex.clear();
+  
+  Entry zero;
+  zero._need = StlDoubleVector(_m, 0);
+  zero._part = 0;
+  zero._first = zero._second = -1;
+  _fronts[ZERO_FRONT].push_back(zero);
+  
+  // the largest subsets come first, so the first feasible size is optimal
+  typedef std::pair<int, Mask> IntMaskPair;
+  typedef std::vector<IntMaskPair> IntMaskPairVector;
+  IntMaskPairVector optimal;
+  unsigned long long nrSubsets = 0;
+  int size = _n;
+  while (size > 0)
+  {
+    for (int p = 0; p < _n; ++p)
+    {
+      if (!_rootCandidate[_order[p]])
+      {
+        continue;
+      }
+      
+      StlIntVector bits;
+      for (int q = p + 1; q < _n; ++q)
+      {
+        if (_descendants[p] & (Mask(1) << q))
+        {
+          bits.push_back(q);
+        }
+      }
+      
+      const int d = bits.size();
+      const int k = size - 1;
+      if (d < k)
+      {
+        continue;
+      }
+      
+      // all k-subsets of the descendants of v_p in colex order
+      uint64_t c = (uint64_t(1) << k) - 1;
+      while (c < (uint64_t(1) << d))
+      {
+        Mask R = 0;
+        for (int b = 0; b < d; ++b)
+        {
+          if (c & (uint64_t(1) << b))
+          {
+            R |= Mask(1) << bits[b];
+          }
+        }
+        
+        // tree() checks the time limit only for subsets that can be spanned
+        if ((++nrSubsets & 1023) == 0 && _timeLimit > 0 && _timer.realTime() > _timeLimit)
+        {
+          std::cerr << "[subset DP aborted, " << _frontIndex.size() << " states]" << std::endl;
+          return false;
+        }
+        
+        if (canSpan(p, R))
+        {
+          int ti = tree(p, R | (Mask(1) << p));
+          if (ti == ABORTED)
+          {
+            std::cerr << "[subset DP aborted, " << _frontIndex.size() << " states]" << std::endl;
+            return false;
+          }
+          if (ti != EMPTY_FRONT)
+          {
+            optimal.push_back(IntMaskPair(p, R | (Mask(1) << p)));
+          }
+        }
+        
+        if (c == 0)
+        {
+          break;
+        }
+        uint64_t lowBit = c & -c;
+        uint64_t ripple = c + lowBit;
+        c = (((ripple ^ c) >> 2) / lowBit) | ripple;
+      }
+    }
+    
+    if (!optimal.empty())
+    {
+      break;
+    }
+    --size;
+  }
+  
+  if (optimal.empty())
+  {
+    return false;
+  }
+  
+  // among the optimal trees pick the one with the smallest VAF deviation
+  StlIntVector bestParent;
+  StlDoubleMatrix bestF;
+  double bestDeviation = -1;
+  for (IntMaskPairVector::const_iterator it = optimal.begin(); it != optimal.end(); ++it)
+  {
+    int p = it->first;
+    const Front& front = _fronts[_frontIndex.find(key(p, true, it->second))->second];
+    for (int idx = 0; idx < front.size(); ++idx)
+    {
+      StlIntVector parent(_n, -2);
+      parent[_order[p]] = -1;
+      reconstructTree(p, it->second, idx, parent);
+      
+      StlDoubleMatrix f;
+      if (!computeFrequencies(parent, f))
+      {
+        continue;
+      }
+      
+      double dev = deviation(f);
+      if (bestDeviation < 0 || dev < bestDeviation)
+      {
+        bestDeviation = dev;
+        bestParent = parent;
+        bestF = f;
+      }
+    }
+  }
+  
+  if (bestDeviation < 0)
+  {
+    return false;
+  }
+  
+  MaxSolution::Triple sol;
+  constructSolution(bestParent, bestF, sol);
+  solution.clear();
+  solution.add(sol);
+  
+  _objValue = size - bestDeviation;
+  std::cerr << "[" << _objValue << ", optimal, " << _frontIndex.size() << " states]" << std::endl;
+  
+  return true;
+}
+
+} // namespace vaff
@@ -0,0 +1,141 @@
+/*
+ *  subsetdpsolver.h
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#ifndef SUBSETDPSOLVER_H
+#define SUBSETDPSOLVER_H
+
+#include "solver.h"
+#include <lemon/time_measure.h>
+#include <unordered_map>
+#include <stdint.h>
+
+namespace vaff {
+
+// exact dynamic program over vertex subsets of G for small graphs, maximizing
+// the number of tree vertices; for every vertex v and subset S it keeps the
+// pareto-minimal per sample frequencies that a subtree rooted at v spanning
+// S needs, the VAF deviation of the largest trees is minimized greedily
+class SubsetDpSolver : public Solver
+{
+public:
+  // graphs with more vertices are not supported
+  static const int MAX_NODES = 30;
+  
+  SubsetDpSolver(const BaseAncestryGraph& G,
+                 const RealIntervalMatrix& F_interval_clustered,
+                 const RealMatrix& F_point_unclustered,
+                 const StlIntMatrix& toUnclusteredColumn,
+                 int timeLimit);
+  
+  // returns false if the time limit or the state limit was hit
+  bool solve(MaxSolution& solution);
+  
+  void applyPresolve(const StlBoolVector& rootCandidate)
+  {
+    _rootCandidate = rootCandidate;
+  }
+  
+  double getObjValue() const
+  {
+    return _objValue;
+  }
+  
+  int getNrStates() const
+  {
+    return _fronts.size();
+  }
+
+private:
+  typedef uint32_t Mask;
+  
+  // need vector of a subtree or of a forest, _part is the vertex set of the
+  // first subtree of a forest, _first and _second index the entries it was
+  // combined from
+  struct Entry
+  {
+    StlDoubleVector _need;
+    Mask _part;
+    int _first;
+    int _second;
+  };
+  
+  typedef std::vector<Entry> Front;
+  typedef std::vector<Front> FrontVector;
+  typedef std::unordered_map<uint64_t, int> FrontIndexMap;
+  
+  enum
+  {
+    EMPTY_FRONT = 0,
+    ZERO_FRONT = 1,
+    ABORTED = -1
+  };
+  
+  const int _n;
+  const int _m;
+  
+  // vertices are identified by their position in a topological order
+  StlIntVector _order;
+  std::vector<Mask> _children;
+  std::vector<Mask> _parents;
+  std::vector<Mask> _ancestors;
+  std::vector<Mask> _descendants;
+  StlBoolVector _rootCandidate;
+  // _lb[p][i] and _ub[p][i] : bounds on f[i][_order[p]]
+  StlDoubleMatrix _lb;
+  StlDoubleMatrix _ub;
+  
+  FrontVector _fronts;
+  FrontIndexMap _frontIndex;
+  
+  lemon::Timer _timer;
+  double _objValue;
+  
+  static uint64_t key(int p, bool tree, Mask S)
+  {
+    return (uint64_t(p) << 33) | (uint64_t(tree) << 32) | S;
+  }
+  
+  static int lowest(Mask S)
+  {
+    assert(S != 0);
+    int p = 0;
+    while (!(S & (Mask(1) << p)))
+    {
+      ++p;
+    }
+    return p;
+  }
+  
+  static int count(Mask S)
+  {
+    int res = 0;
+    for (; S != 0; S &= S - 1)
+    {
+      ++res;
+    }
+    return res;
+  }
+  
+  // cheap necessary conditions for a forest below v_p spanning R
+  bool canSpan(int p, Mask R) const;
+  
+  bool addEntry(Front& front, const Entry& entry) const;
+  
+  int tree(int p, Mask S);
+  
+  int forest(int p, Mask R);
+  
+  int store(uint64_t k, const Front& front);
+  
+  void reconstructTree(int p, Mask S, int idx, StlIntVector& parent) const;
+  
+  void reconstructForest(int p, Mask R, int idx, StlIntVector& parent) const;
+};
+
+} // namespace vaff
+
+#endif // SUBSETDPSOLVER_H
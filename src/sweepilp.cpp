@@ -0,0 +1,207 @@
+/*
+ *  sweepilp.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "utils.h"
+#include "readcountmatrix.h"
+#include "ancestrymatrix.h"
+#include "probancestrygraph.h"
+#include "presolver.h"
+#include "intmaxilpsolver.h"
+#include <lemon/time_measure.h>
+#include <fstream>
+#include <sstream>
+
+using namespace vaff;
+
+void printUsage(const char* argv0, std::ostream& out)
+{
+  out << "Usage: " << argv0 << " <ALPHAS> <BETAS> <GAMMAS> <TIMELIMIT> <READ_COUNTS> [<SOL_PREFIX>] where" << std::endl
+      << "  <ALPHAS>           comma separated alpha parameters (clustering)" << std::endl
+      << "  <BETAS>            comma separated beta parameters (ancestry)" << std::endl
+      << "  <GAMMAS>           comma separated gamma parameters (CI)" << std::endl
+      << "  <TIMELIMIT>        time limit in seconds per solve (use -1 to disable time limit)" << std::endl
+      << "  <READ_COUNTS>      read count file" << std::endl
+      << "  <SOL_PREFIX>       solutions are written to <SOL_PREFIX>_<ALPHA>_<BETA>_<GAMMA>.sol" << std::endl;
+  out << "The ILP is only rebuilt if the clustering changes, otherwise its bounds are\n"
+         "updated in place and it is solved starting from the previous solution.\n"
+         "Output (tab separated, one line per parameter combination):\n"
+         "  alpha\n"
+         "  beta\n"
+         "  gamma\n"
+         "  model ('built' or 'updated')\n"
+         "  |V|\n"
+         "  |A|\n"
+         "  objective value\n"
+         "  best bound\n"
+         "  solve time (s)" << std::endl;
+}
+
+bool parseList(const char* str,
+               double lb,
+               double ub,
+               StlDoubleVector& values)
+{
+  std::stringstream ss(str);
+  std::string token;
+  while (std::getline(ss, token, ','))
+  {
+    double value = -1;
+    if (sscanf(token.c_str(), "%lf", &value) != 1 || !(lb <= value && value <= ub))
+    {
+      return false;
+    }
+    values.push_back(value);
+  }
+  
+  return !values.empty();
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 6)
+  {
+    printUsage(argv[0], std::cerr);
+    return 1;
+  }
+  
+  StlDoubleVector alphas;
+  if (!parseList(argv[1], 0, 0.5, alphas))
+  {
+    std::cerr << "Error: alpha must be in [0,0.5]" << std::endl;
+    return 1;
+  }
+  
+  StlDoubleVector betas;
+  if (!parseList(argv[2], 0.5, 1, betas))
+  {
+    std::cerr << "Error: beta must be in [0.5,1]" << std::endl;
+    return 1;
+  }
+  
+  StlDoubleVector gammas;
+  if (!parseList(argv[3], 0, 1, gammas))
+  {
+    std::cerr << "Error: gamma must be in [0,1]" << std::endl;
+    return 1;
+  }
+  
+  int timeLimit = atoi(argv[4]);
+  
+  ReadCountMatrix R;
+  std::ifstream in(argv[5]);
+  if (!in.good())
+  {
+    std::cerr << "Error: failed to open '" << argv[5] << "' for reading" << std::endl;
+    return 1;
+  }
+  in >> R;
+  in.close();
+  
+  std::string solPrefix = argc > 6 ? argv[6] : "";
+  
+  // entries below 0.5 - alpha do not affect the graphs
+  AncestryMatrix A(R, 0, 0.5 - *std::max_element(alphas.begin(), alphas.end()));
+  RealMatrix F;
+  R.computePointEstimates(F);
+  
+  // the model has the arcs of the smallest beta, larger betas disable arcs
+  double minBeta = *std::min_element(betas.begin(), betas.end());
+  
+  for (StlDoubleVector::const_iterator itAlpha = alphas.begin(); itAlpha != alphas.end(); ++itAlpha)
+  {
+    double alpha = *itAlpha;
+    
+    // the model refers to these, CI is changed in place upon every gamma
+    StlIntMatrix modelColumns;
+    ProbAncestryGraph modelGraph;
+    RealIntervalMatrix CI;
+    IntMaxIlpSolver* pSolver = NULL;
+    bool loaded = false;
+    MaxSolution previous(F);
+    
+    for (StlDoubleVector::const_iterator itGamma = gammas.begin(); itGamma != gammas.end(); ++itGamma)
+    {
+      double gamma = *itGamma;
+      
+      // gamma affects which mutations are in G and hence the clustering
+      ProbAncestryGraph G(A, R, alpha, gamma);
+      StlIntMatrix toOrginalColumns;
+      G.removeCycles(A, alpha, toOrginalColumns);
+      ReadCountMatrix newR = R.collapse(toOrginalColumns);
+      
+      if (!pSolver || toOrginalColumns != modelColumns)
+      {
+        delete pSolver;
+        modelColumns = toOrginalColumns;
+        G.contract(A, modelColumns, minBeta, modelGraph);
+        newR.computeConfidenceIntervals(CI, gamma);
+        pSolver = new IntMaxIlpSolver(modelGraph, CI, F, modelColumns, timeLimit);
+        loaded = false;
+      }
+      else
+      {
+        newR.computeConfidenceIntervals(CI, gamma);
+      }
+      
+      for (StlDoubleVector::const_iterator itBeta = betas.begin(); itBeta != betas.end(); ++itBeta)
+      {
+        double beta = *itBeta;
+        
+        ProbAncestryGraph H;
+        G.contract(A, modelColumns, beta, H);
+        Presolver presolver(H, CI);
+        presolver.run();
+        
+        pSolver->update(H);
+        pSolver->applyPresolve(presolver.getRootCandidates(),
+                               presolver.getNonRootIntervals());
+        if (previous.size() > 0)
+        {
+          pSolver->setMipStart(previous.solution(0));
+        }
+        
+        lemon::Timer timer;
+        MaxSolution solution(F);
+        bool solved = pSolver->solve(solution);
+        
+        std::cout << alpha << "\t" << beta << "\t" << gamma << "\t"
+                  << (loaded ? "updated" : "built") << "\t"
+                  << lemon::countNodes(H.getG()) << "\t"
+                  << lemon::countArcs(H.getG()) << "\t";
+        if (solved)
+        {
+          std::cout << pSolver->getObjValue() << "\t" << pSolver->getBestObjValue();
+        }
+        else
+        {
+          std::cout << "-\t-";
+        }
+        std::cout << "\t" << timer.realTime() << std::endl;
+        loaded = true;
+        
+        if (!solved)
+        {
+          continue;
+        }
+        previous = solution;
+        
+        if (solPrefix != "")
+        {
+          std::stringstream filename;
+          filename << solPrefix << "_" << alpha << "_" << beta << "_" << gamma << ".sol";
+          std::ofstream out(filename.str().c_str());
+          out << solution;
+          out.close();
+        }
+      }
+    }
+    
+    delete pSolver;
+  }
+  
+  return 0;
+}
@@ -0,0 +1,248 @@
+/*
+ *  vafclustering.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "vafclustering.h"
+#include "ancestrymatrix.h"
+#include <lemon/list_graph.h>
+#include <lemon/connectivity.h>
+
+namespace vaff {
+
+VafClustering::VafClustering(const ReadCountMatrix& R,
+                             double gamma)
+  : _R(R)
+  , _CI()
+  , _nrTestedPairs(0)
+{
+  R.computeConfidenceIntervals(_CI, gamma);
+  
+  const int m = R.getNrCols();
+  const int n = R.getNrRows();
+  for (int i = 0; i < m; ++i)
+  {
+    for (int p = 0; p < n; ++p)
+    {
+      if (R.getAlt(p, i) == 0 && R.getRef(p, i) == 0)
+      {
+        _CI.set(i, p, RealInterval(0, 1));
+      }
+    }
+  }
+}
+
+bool VafClustering::overlap(int i, int p, int q) const
+{
+  return _CI(i, p).first <= _CI(i, q).second && _CI(i, q).first <= _CI(i, p).second;
+}
+
+int VafClustering::sweepSample() const
+{
+  const int m = _R.getNrCols();
+  const int n = _R.getNrRows();
+  
+  int best_i = 0;
+  double bestRatio = -1;
+  for (int i = 0; i < m; ++i)
+  {
+    double minMid = 1, maxMid = 0, width = 0;
+    for (int p = 0; p < n; ++p)
+    {
+      const RealInterval& I = _CI(i, p);
+      double mid = (I.first + I.second) / 2;
+      minMid = std::min(minMid, mid);
+      maxMid = std::max(maxMid, mid);
+      width += I.second - I.first;
+    }
+    double ratio = (maxMid - minMid) / std::max(width / n, 1e-9);
+    if (ratio > bestRatio)
+    {
+      bestRatio = ratio;
+      best_i = i;
+    }
+  }
+  
+  return best_i;
+}
+
+int VafClustering::find(StlIntVector& parent, int p)
+{
+  while (parent[p] != p)
+  {
+    parent[p] = parent[parent[p]];
+    p = parent[p];
+  }
+  return p;
+}
+
+void VafClustering::run(StlIntMatrix& toOrgColumns)
+{
+  typedef std::pair<double, int> DoubleIntPair;
+  typedef std::vector<DoubleIntPair> DoubleIntPairVector;
+  
+  const int m = _R.getNrCols();
+  const int n = _R.getNrRows();
+  
+  // mutations sorted by lower bound in the sweep sample
+  const int s = n == 0 ? 0 : sweepSample();
+  DoubleIntPairVector sorted;
+  for (int p = 0; p < n; ++p)
+  {
+    bool feasible = true;
+    for (int i = 0; i < m; ++i)
+    {
+      if (_CI(i, p).first > 0.5)
+      {
+        feasible = false;
+        break;
+      }
+    }
+    if (feasible)
+    {
+      sorted.push_back(DoubleIntPair(_CI(s, p).first, p));
+    }
+  }
+  std::sort(sorted.begin(), sorted.end());
+  
+  StlIntVector parent(n);
+  for (int p = 0; p < n; ++p)
+  {
+    parent[p] = p;
+  }
+  
+  // q overlaps p in the sweep sample iff its lower bound does not exceed
+  // the upper bound of p
+  _nrTestedPairs = 0;
+  const int nn = sorted.size();
+  for (int a = 0; a < nn; ++a)
+  {
+    int p = sorted[a].second;
+    double UB_p = _CI(s, p).second;
+    for (int b = a + 1; b < nn && sorted[b].first <= UB_p; ++b)
+    {
+      int q = sorted[b].second;
+      ++_nrTestedPairs;
+      
+      int root_p = find(parent, p);
+      int root_q = find(parent, q);
+      if (root_p == root_q)
+      {
+        continue;
+      }
+      
+      bool overlapping = true;
+      for (int i = 0; i < m && overlapping; ++i)
+      {
+        overlapping = overlap(i, p, q);
+      }
+      if (overlapping)
+      {
+        parent[root_q] = root_p;
+      }
+    }
+  }
+  
+  StlIntVector toCluster(n, -1);
+  toOrgColumns.clear();
+  for (int a = 0; a < nn; ++a)
+  {
+    int p = sorted[a].second;
+    int root_p = find(parent, p);
+    if (toCluster[root_p] == -1)
+    {
+      toCluster[root_p] = toOrgColumns.size();
+      toOrgColumns.push_back(StlIntVector());
+    }
+  }
+  for (int p = 0; p < n; ++p)
+  {
+    int c = toCluster[find(parent, p)];
+    if (c != -1)
+    {
+      toOrgColumns[c].push_back(p);
+    }
+  }
+}
+
+void VafClustering::verify(double alpha,
+                           StlIntMatrix& toOrgColumns) const
+{
+  typedef lemon::ListDigraph Digraph;
+  DIGRAPH_TYPEDEFS(Digraph);
+  
+  const int m = _R.getNrCols();
+  const int n = _R.getNrRows();
+  
+  int max_count = 0;
+  for (int i = 0; i < m; ++i)
+  {
+    for (int p = 0; p < n; ++p)
+    {
+      max_count = std::max(max_count, std::max(_R.getAlt(p, i), _R.getRef(p, i)));
+    }
+  }
+  StlDoubleVector log_fact;
+  AncestryMatrix::constructLogFactorialTable(4*max_count, log_fact);
+  
+  StlIntMatrix result;
+  for (StlIntMatrixIt it = toOrgColumns.begin(); it != toOrgColumns.end(); ++it)
+  {
+    const StlIntVector& S = *it;
+    if (S.size() == 1)
+    {
+      result.push_back(S);
+      continue;
+    }
+    
+    Digraph G;
+    std::vector<Node> nodes;
+    for (StlIntVectorIt it2 = S.begin(); it2 != S.end(); ++it2)
+    {
+      nodes.push_back(G.addNode());
+    }
+    
+    // only pairs that can reach 0.5 - alpha are computed, as in AncestryMatrix
+    StlIntMatrix singletons;
+    for (StlIntVectorIt it2 = S.begin(); it2 != S.end(); ++it2)
+    {
+      singletons.push_back(StlIntVector(1, *it2));
+    }
+    ReadCountMatrix subR = _R.collapse(singletons);
+    StlIntMatrix candidates;
+    AncestryMatrix::candidatePairs(subR, 0, 0.5 - alpha, candidates);
+    
+    const int size = S.size();
+    for (int j = 0; j < size; ++j)
+    {
+      for (StlIntVectorIt it2 = candidates[j].begin(); it2 != candidates[j].end(); ++it2)
+      {
+        int k = *it2;
+        if (j == k)
+        {
+          continue;
+        }
+        double prob_j_precedes_k = AncestryMatrix::prob(subR, 0, log_fact, j, k);
+        if (0.5 - alpha <= prob_j_precedes_k && prob_j_precedes_k <= 0.5 + alpha)
+        {
+          G.addArc(nodes[j], nodes[k]);
+        }
+      }
+    }
+    
+    IntNodeMap sccMap(G);
+    int nrComponents = lemon::stronglyConnectedComponents(G, sccMap);
+    int offset = result.size();
+    result.resize(offset + nrComponents);
+    for (int j = 0; j < size; ++j)
+    {
+      result[offset + sccMap[nodes[j]]].push_back(S[j]);
+    }
+  }
+  
+  toOrgColumns = result;
+}
+
+} // namespace vaff
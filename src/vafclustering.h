@@ -0,0 +1,66 @@
+/*
+ *  vafclustering.h
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#ifndef VAFCLUSTERING_H
+#define VAFCLUSTERING_H
+
+#include "utils.h"
+#include "readcountmatrix.h"
+#include "realintervalmatrix.h"
+
+namespace vaff {
+
+// clusters mutations directly in VAF space without the n^2 ancestry matrix:
+// every mutation is a box of per-sample confidence intervals and mutations
+// whose boxes overlap are merged by union-find, overlapping pairs are found
+// by a sweep over the sample that separates the intervals best. Unlike
+// ProbAncestryGraph::removeCycles, clusters are grown by chains of
+// overlapping boxes; verify splits them into the strongly connected
+// components of intermediate arcs, computing the ancestry probabilities only
+// within each cluster. This approximates removeCycles: a cycle of
+// intermediate arcs through mutations of different boxes is never merged.
+// Mutations with a lower bound above 0.5 are left out, as in
+// ProbAncestryGraph
+class VafClustering
+{
+public:
+  VafClustering(const ReadCountMatrix& R,
+                double gamma);
+  
+  // toOrgColumns[c] : mutations of cluster c
+  void run(StlIntMatrix& toOrgColumns);
+  
+  // splits every cluster into the strongly connected components of the arcs
+  // (v_j,v_k) with 0.5 - alpha <= A(j,k) <= 0.5 + alpha within that cluster,
+  // arcs between clusters are not considered
+  void verify(double alpha,
+              StlIntMatrix& toOrgColumns) const;
+  
+  // number of box pairs tested by the sweep
+  long long getNrTestedPairs() const
+  {
+    return _nrTestedPairs;
+  }
+
+private:
+  const ReadCountMatrix& _R;
+  RealIntervalMatrix _CI;
+  long long _nrTestedPairs;
+  
+  // sample whose intervals have the largest spread of midpoints relative
+  // to their mean width
+  int sweepSample() const;
+  
+  // samples without reads do not constrain the VAF
+  bool overlap(int i, int p, int q) const;
+  
+  static int find(StlIntVector& parent, int p);
+};
+
+} // namespace vaff
+
+#endif // VAFCLUSTERING_H
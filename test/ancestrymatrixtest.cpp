@@ -0,0 +1,193 @@
+/*
+ *  ancestrymatrixtest.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "testinstance.h"
+
+using namespace vaff;
+
+// entries of at least threshold are equal, the others are below threshold
+// in both matrices
+int compare(const AncestryMatrix& A,
+            const AncestryMatrix& B,
+            double threshold,
+            double tol)
+{
+  const int n = A.getNrRows();
+  if (B.getNrRows() != n)
+  {
+    std::cerr << "Size " << A.getNrRows() << " instead of " << B.getNrRows() << std::endl;
+    return 1;
+  }
+  
+  int nrFailed = 0;
+  for (int p = 0; p < n; ++p)
+  {
+    for (int q = 0; q < n; ++q)
+    {
+      if (A(p, q) >= threshold || B(p, q) >= threshold)
+      {
+        if (fabs(A(p, q) - B(p, q)) > tol)
+        {
+          std::cerr << "Entry (" << p << "," << q << "): " << A(p, q) << " instead of " << B(p, q) << std::endl;
+          ++nrFailed;
+        }
+      }
+    }
+  }
+  return nrFailed;
+}
+
+int checkCandidatePairs(const ReadCountMatrix& R,
+                        int order,
+                        double threshold)
+{
+  AncestryMatrix full(R, order);
+  AncestryMatrix A(R, order, threshold);
+  int nrFailed = compare(A, full, threshold, 0);
+  
+  StlIntMatrix candidates;
+  AncestryMatrix::candidatePairs(R, order, threshold, candidates);
+  
+  const int n = R.getNrRows();
+  for (int p = 0; p < n; ++p)
+  {
+    StlBoolVector candidate(n, false);
+    for (StlIntVectorIt it = candidates[p].begin(); it != candidates[p].end(); ++it)
+    {
+      candidate[*it] = true;
+    }
+    for (int q = 0; q < n; ++q)
+    {
+      if (p != q && full(p, q) >= threshold && !candidate[q])
+      {
+        std::cerr << "Pair (" << p << "," << q << ") with " << full(p, q) << " is no candidate" << std::endl;
+        ++nrFailed;
+      }
+    }
+  }
+  
+  return nrFailed;
+}
+
+// first nrMutations mutations of R in its first nrSamples samples
+ReadCountMatrix prefix(const ReadCountMatrix& R,
+                       int nrMutations,
+                       int nrSamples)
+{
+  ReadCountMatrix res(nrMutations, nrSamples);
+  for (int p = 0; p < nrMutations; ++p)
+  {
+    res.setRowLabel(p, R.getRowLabel(p));
+    for (int i = 0; i < nrSamples; ++i)
+    {
+      res.set(p, i, R.getAlt(p, i), R.getRef(p, i));
+    }
+  }
+  for (int i = 0; i < nrSamples; ++i)
+  {
+    res.setColLabel(i, R.getColLabel(i));
+  }
+  return res;
+}
+
+int checkExtend(const ReadCountMatrix& R,
+                int order,
+                double threshold)
+{
+  const int n = R.getNrRows();
+  const int m = R.getNrCols();
+  AncestryMatrix full(R, order, threshold);
+  
+  AncestryMatrix A(prefix(R, n / 2, m), order, threshold);
+  if (!A.extend(R))
+  {
+    std::cerr << "Extending mutations failed" << std::endl;
+    return 1;
+  }
+  int nrFailed = compare(A, full, threshold, 0);
+  
+  // as construct_ancestry_matrix, from a matrix written with 6 digits
+  std::stringstream ss;
+  ss << AncestryMatrix(prefix(R, n / 2, m), order, threshold);
+  AncestryMatrix B;
+  ss >> B;
+  if (!B.extend(R))
+  {
+    std::cerr << "Extending a parsed matrix failed" << std::endl;
+    return nrFailed + 1;
+  }
+  nrFailed += compare(B, full, threshold, 1e-5);
+  
+  // the read counts of an existing mutation changed
+  ReadCountMatrix changed = R;
+  changed.set(0, 0, R.getAlt(0, 0) + 1, R.getRef(0, 0));
+  AncestryMatrix C(prefix(R, n / 2, m), order, threshold);
+  if (C.extend(changed) || C.getNrRows() != n / 2)
+  {
+    std::cerr << "Extended a matrix of other read counts" << std::endl;
+    ++nrFailed;
+  }
+  
+  return nrFailed;
+}
+
+// only supported for order 0
+int checkAddSamples(const ReadCountMatrix& R,
+                    double threshold)
+{
+  const int n = R.getNrRows();
+  const int m = R.getNrCols();
+  AncestryMatrix full(R, 0, threshold);
+  
+  // appended samples only
+  AncestryMatrix A(prefix(R, n, m - 1), 0, threshold);
+  if (!A.extend(R))
+  {
+    std::cerr << "Extending samples failed" << std::endl;
+    return 1;
+  }
+  int nrFailed = compare(A, full, threshold, 0);
+  
+  // appended samples and mutations
+  AncestryMatrix B(prefix(R, n / 2, m - 2), 0, threshold);
+  if (!B.extend(R))
+  {
+    std::cerr << "Extending samples and mutations failed" << std::endl;
+    return nrFailed + 1;
+  }
+  nrFailed += compare(B, full, threshold, 0);
+  
+  // appended samples for order 1 are not supported
+  AncestryMatrix C(prefix(R, n, m - 1), 1, threshold);
+  if (C.extend(R))
+  {
+    std::cerr << "Extended samples for order 1" << std::endl;
+    ++nrFailed;
+  }
+  
+  return nrFailed;
+}
+
+int main(int argc, char** argv)
+{
+  std::mt19937 rng(4);
+  
+  int nrFailed = 0;
+  for (int trial = 0; trial < 5; ++trial)
+  {
+    ReadCountMatrix R = simulateReadCounts(rng, 8, 4, 4, 100);
+    for (int order = 0; order < 2; ++order)
+    {
+      nrFailed += checkCandidatePairs(R, order, 0.2);
+      nrFailed += checkExtend(R, order, 0.2);
+    }
+    nrFailed += checkAddSamples(R, 0.2);
+  }
+  
+  std::cerr << nrFailed << " failed" << std::endl;
+  return nrFailed == 0 ? 0 : 1;
+}
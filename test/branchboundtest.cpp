@@ -0,0 +1,158 @@
+/*
+ *  branchboundtest.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "testinstance.h"
+#include "branchboundsolver.h"
+#include "presolver.h"
+
+using namespace vaff;
+
+// the presolver modifies the graph, so it runs on a copy of the instance,
+// and must keep every root of a largest tree
+int checkPresolve(const ReadCountMatrix& R,
+                  const TestInstance& instance,
+                  const BruteForceSolver& bruteForce,
+                  int trial)
+{
+  int nrFailed = 0;
+  
+  TestInstance presolved(R, 0.3, 0.8, 0.01);
+  presolved._CI = instance._CI;
+  Presolver presolver(presolved._H, presolved._CI);
+  presolver.run();
+  for (int j = 0; j < presolved._CI.getNrCols(); ++j)
+  {
+    if (bruteForce.isLargestTreeRoot(j) && !presolver.getRootCandidates()[j])
+    {
+      std::cerr << "Instance " << trial << ": presolve excludes root " << j << std::endl;
+      ++nrFailed;
+    }
+  }
+  
+  BranchBoundSolver bb(presolved._H,
+                       presolved._CI,
+                       presolved._F,
+                       presolved._toOrgColumns,
+                       -1,
+                       2);
+  bb.applyPresolve(presolver.getRootCandidates());
+  MaxSolution solution(presolved._F);
+  bool solved = bb.solve(solution);
+  int size = solved ? solution.solution(0)._F.getNrCols() : 0;
+  if (size != bruteForce.getBestSize())
+  {
+    std::cerr << "Instance " << trial << ": presolved branch and bound " << size
+              << ", brute force " << bruteForce.getBestSize() << std::endl;
+    ++nrFailed;
+  }
+  
+  return nrFailed;
+}
+
+int main(int argc, char** argv)
+{
+  std::mt19937 rng(1);
+  
+  int nrInstances = 0;
+  int nrFailed = 0;
+  for (int trial = 0; nrInstances < 20 && trial < 200; ++trial)
+  {
+    ReadCountMatrix R = simulateReadCounts(rng, 6, 2, 3, 100);
+    TestInstance instance(R, 0.3, 0.8, 0.01);
+    const int n = instance._CI.getNrCols();
+    if (n < 3 || n > 9)
+    {
+      continue;
+    }
+    
+    // a cluster of an optimal tree whose lower bound exceeds 0.5 can be
+    // neither root nor vertex, alternately the root or another vertex
+    if (trial % 2 == 1)
+    {
+      BranchBoundSolver bb(instance._H,
+                           instance._CI,
+                           instance._F,
+                           instance._toOrgColumns,
+                           -1,
+                           1);
+      MaxSolution solution(instance._F);
+      StlIntVector parent;
+      if (bb.solve(solution) && bb.mapSolution(solution.solution(0), parent))
+      {
+        int j = std::find(parent.begin(), parent.end(), -1) - parent.begin();
+        for (int k = 0; k < n && trial % 4 == 3; ++k)
+        {
+          if (parent[k] >= 0)
+          {
+            j = k;
+          }
+        }
+        instance._CI.set(0, j, RealInterval(0.6, 0.7));
+      }
+    }
+    
+    BruteForceSolver bruteForce(instance._H,
+                                instance._CI,
+                                instance._F,
+                                instance._toOrgColumns);
+    MaxSolution unused;
+    bool expected = bruteForce.solve(unused);
+    
+    BranchBoundSolver bb(instance._H,
+                         instance._CI,
+                         instance._F,
+                         instance._toOrgColumns,
+                         -1,
+                         2);
+    MaxSolution solution(instance._F);
+    bool solved = bb.solve(solution);
+    
+    int size = solved ? solution.solution(0)._F.getNrCols() : 0;
+    if (solved != expected || size != bruteForce.getBestSize() || !bb.isOptimal())
+    {
+      std::cerr << "Instance " << trial << ": branch and bound " << size
+                << ", brute force " << bruteForce.getBestSize() << std::endl;
+      ++nrFailed;
+    }
+    
+    nrFailed += checkPresolve(R, instance, bruteForce, trial);
+    ++nrInstances;
+  }
+  
+  // a chain a -> b -> c whose top cluster a has a lower bound above 0.5,
+  // so the largest tree b -> c is shorter than the path starting at a
+  ReadCountMatrix R(3, 1);
+  R.setColLabel(0, "s0");
+  const int vaf[] = {45, 30, 15};
+  for (int p = 0; p < 3; ++p)
+  {
+    std::stringstream ss;
+    ss << "m" << p;
+    R.setRowLabel(p, ss.str());
+    R.set(p, 0, 10 * vaf[p], 10 * (100 - vaf[p]));
+  }
+  TestInstance chain(R, 0.3, 0.8, 0.01);
+  for (int j = 0; j < chain._CI.getNrCols(); ++j)
+  {
+    if (chain._toOrgColumns[j][0] == 0)
+    {
+      chain._CI.set(0, j, RealInterval(0.6, 0.7));
+    }
+  }
+  BruteForceSolver bruteForce(chain._H, chain._CI, chain._F, chain._toOrgColumns);
+  MaxSolution unused;
+  bruteForce.solve(unused);
+  if (chain._CI.getNrCols() != 3 || bruteForce.getBestSize() != 2)
+  {
+    std::cerr << "Chain instance: brute force " << bruteForce.getBestSize() << std::endl;
+    ++nrFailed;
+  }
+  nrFailed += checkPresolve(R, chain, bruteForce, -1);
+  
+  std::cerr << nrInstances << " instances, " << nrFailed << " failed" << std::endl;
+  return nrInstances > 0 && nrFailed == 0 ? 0 : 1;
+}
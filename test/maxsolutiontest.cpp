@@ -0,0 +1,88 @@
+/*
+ *  maxsolutiontest.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "testinstance.h"
+#include "branchboundsolver.h"
+
+using namespace vaff;
+
+int main(int argc, char** argv)
+{
+  std::mt19937 rng(3);
+  
+  ReadCountMatrix R = simulateReadCounts(rng, 6, 2, 3, 100);
+  TestInstance instance(R, 0.3, 0.8, 0.01);
+  
+  BranchBoundSolver bb(instance._H,
+                       instance._CI,
+                       instance._F,
+                       instance._toOrgColumns,
+                       -1,
+                       1);
+  MaxSolution solution(instance._F);
+  if (!bb.solve(solution))
+  {
+    std::cerr << "No solution" << std::endl;
+    return 1;
+  }
+  const MaxSolution::Triple& triple = solution.solution(0);
+  
+  int nrFailed = 0;
+  
+  // triples that differ in one frequency, also below 1e-6
+  MaxSolution::TripleVector triples;
+  for (int k = 0; k < 200; ++k)
+  {
+    MaxSolution::Triple t = triple;
+    t._F.set(0, 0, t._F(0, 0) + (k % 2 ? k * 1e-3 : k * 1e-9));
+    triples.push_back(t);
+  }
+  
+  MaxSolution pool(instance._F);
+  for (int k = 0; k < 100; ++k)
+  {
+    if (!pool.present(triples[k]))
+    {
+      pool.add(triples[k]);
+    }
+  }
+  if (pool.size() != 100)
+  {
+    std::cerr << "Pool has " << pool.size() << " instead of 100 triples" << std::endl;
+    ++nrFailed;
+  }
+  
+  // present agrees with a linear scan
+  for (int k = 0; k < 200; ++k)
+  {
+    bool expected = false;
+    for (int idx = 0; idx < pool.size(); ++idx)
+    {
+      expected |= pool.solution(idx) == triples[k];
+    }
+    if (pool.present(triples[k]) != expected)
+    {
+      std::cerr << "Triple " << k << ": present " << !expected << std::endl;
+      ++nrFailed;
+    }
+  }
+  
+  // column labels are not compared
+  MaxSolution::Triple relabeled = triples[0];
+  for (int j = 0; j < relabeled._F.getNrCols(); ++j)
+  {
+    relabeled._F.setColLabel(j, "relabeled");
+  }
+  if (!(relabeled == triples[0]) || !pool.present(relabeled))
+  {
+    std::cerr << "Relabeled triple not present" << std::endl;
+    ++nrFailed;
+  }
+  
+  std::cerr << nrFailed << " failed" << std::endl;
+  return nrFailed == 0 ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+/*
+ *  subsetdptest.cpp
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#include "testinstance.h"
+#include "subsetdpsolver.h"
+
+using namespace vaff;
+
+int main(int argc, char** argv)
+{
+  std::mt19937 rng(2);
+  
+  int nrInstances = 0;
+  int nrFailed = 0;
+  for (int trial = 0; nrInstances < 20 && trial < 200; ++trial)
+  {
+    ReadCountMatrix R = simulateReadCounts(rng, 6, 2, 3, 100);
+    TestInstance instance(R, 0.3, 0.8, 0.01);
+    const int n = instance._CI.getNrCols();
+    if (n < 3 || n > 9)
+    {
+      continue;
+    }
+    
+    // a cluster whose lower bound exceeds 0.5 can be neither root nor vertex
+    if (trial % 2 == 1)
+    {
+      instance._CI.set(0, trial % n, RealInterval(0.6, 0.7));
+    }
+    
+    BruteForceSolver bruteForce(instance._H,
+                                instance._CI,
+                                instance._F,
+                                instance._toOrgColumns);
+    MaxSolution unused;
+    bool expected = bruteForce.solve(unused);
+    
+    SubsetDpSolver dp(instance._H,
+                      instance._CI,
+                      instance._F,
+                      instance._toOrgColumns,
+                      -1);
+    MaxSolution solution(instance._F);
+    bool solved = dp.solve(solution);
+    
+    int size = solved ? solution.solution(0)._F.getNrCols() : 0;
+    if (solved != expected || size != bruteForce.getBestSize())
+    {
+      std::cerr << "Instance " << trial << ": subset DP " << size
+                << ", brute force " << bruteForce.getBestSize() << std::endl;
+      ++nrFailed;
+    }
+    ++nrInstances;
+  }
+  
+  std::cerr << nrInstances << " instances, " << nrFailed << " failed" << std::endl;
+  return nrInstances > 0 && nrFailed == 0 ? 0 : 1;
+}
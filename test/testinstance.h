@@ -0,0 +1,206 @@
+/*
+ *  testinstance.h
+ *
+ *   Created on: 19-oct-2026
+ *       Author: M. El-Kebir
+ */
+
+#ifndef TESTINSTANCE_H
+#define TESTINSTANCE_H
+
+#include "utils.h"
+#include "readcountmatrix.h"
+#include "ancestrymatrix.h"
+#include "probancestrygraph.h"
+#include "realintervalmatrix.h"
+#include "realmatrix.h"
+#include "solver.h"
+#include <random>
+#include <sstream>
+#include <iostream>
+
+namespace vaff {
+
+// read counts of a random clonal tree: every clone has nrMutationsPerClone
+// mutations whose VAF in a sample is half the cell fraction of its subtree
+inline ReadCountMatrix simulateReadCounts(std::mt19937& rng,
+                                          int nrClones,
+                                          int nrMutationsPerClone,
+                                          int nrSamples,
+                                          int coverage)
+{
+  StlIntVector parent(nrClones, -1);
+  for (int c = 1; c < nrClones; ++c)
+  {
+    parent[c] = std::uniform_int_distribution<int>(0, c - 1)(rng);
+  }
+  
+  ReadCountMatrix R(nrClones * nrMutationsPerClone, nrSamples);
+  for (int i = 0; i < nrSamples; ++i)
+  {
+    std::stringstream ss;
+    ss << "s" << i;
+    R.setColLabel(i, ss.str());
+    
+    StlDoubleVector freq(nrClones, 0);
+    double sum = 0;
+    for (int c = 0; c < nrClones; ++c)
+    {
+      freq[c] = std::uniform_real_distribution<double>(0, 1)(rng);
+      sum += freq[c];
+    }
+    for (int c = 0; c < nrClones; ++c)
+    {
+      freq[c] /= sum;
+    }
+    // children come after their parent
+    for (int c = nrClones - 1; c > 0; --c)
+    {
+      freq[parent[c]] += freq[c];
+    }
+    
+    for (int c = 0; c < nrClones; ++c)
+    {
+      std::binomial_distribution<int> alt(coverage, freq[c] / 2);
+      for (int l = 0; l < nrMutationsPerClone; ++l)
+      {
+        int a = alt(rng);
+        R.set(c * nrMutationsPerClone + l, i, a, coverage - a);
+      }
+    }
+  }
+  
+  for (int p = 0; p < R.getNrRows(); ++p)
+  {
+    std::stringstream ss;
+    ss << "m" << p;
+    R.setRowLabel(p, ss.str());
+  }
+  
+  return R;
+}
+
+// the clustered graph and intervals of R, as computed by ancestree
+struct TestInstance
+{
+  TestInstance(const ReadCountMatrix& R,
+               double alpha,
+               double beta,
+               double gamma)
+    : _F()
+    , _toOrgColumns()
+    , _CI()
+    , _H()
+  {
+    AncestryMatrix A(R, 0);
+    ProbAncestryGraph G(A, R, alpha, gamma);
+    G.removeCycles(A, alpha, _toOrgColumns);
+    R.computePointEstimates(_F);
+    ReadCountMatrix newR = R.collapse(_toOrgColumns);
+    _CI = RealIntervalMatrix(newR.getNrCols(), newR.getNrRows());
+    newR.computeConfidenceIntervals(_CI, gamma);
+    G.contract(A, _toOrgColumns, beta, _H);
+  }
+  
+  RealMatrix _F;
+  StlIntMatrix _toOrgColumns;
+  RealIntervalMatrix _CI;
+  ProbAncestryGraph _H;
+};
+
+// enumerates every tree of G, in topological order every vertex is left
+// out, the root or attached to an in-neighbor already in the tree
+class BruteForceSolver : public Solver
+{
+public:
+  BruteForceSolver(const BaseAncestryGraph& G,
+                   const RealIntervalMatrix& F_interval_clustered,
+                   const RealMatrix& F_point_unclustered,
+                   const StlIntMatrix& toUnclusteredColumn)
+    : Solver(G, F_interval_clustered, F_point_unclustered, toUnclusteredColumn, -1)
+    , _order()
+    , _parent()
+    , _bestSize(0)
+    , _largestTreeRoot()
+  {
+  }
+  
+  bool solve(MaxSolution&)
+  {
+    topologicalOrder(_order);
+    _parent = StlIntVector(_F_interval_clustered.getNrCols(), -2);
+    _bestSize = 0;
+    _largestTreeRoot = StlBoolVector(_parent.size(), false);
+    enumerate(0, false);
+    return _bestSize > 0;
+  }
+  
+  // largest number of vertices of a tree with feasible frequencies
+  int getBestSize() const
+  {
+    return _bestSize;
+  }
+  
+  // whether cluster j is the root of a tree with getBestSize() vertices
+  bool isLargestTreeRoot(int j) const
+  {
+    return _largestTreeRoot[j];
+  }
+
+private:
+  StlIntVector _order;
+  StlIntVector _parent;
+  int _bestSize;
+  StlBoolVector _largestTreeRoot;
+  
+  void enumerate(int idx, bool rooted)
+  {
+    if (idx == static_cast<int>(_order.size()))
+    {
+      StlDoubleMatrix f;
+      if (rooted && computeFrequencies(_parent, f))
+      {
+        int size = _parent.size() - std::count(_parent.begin(), _parent.end(), -2);
+        if (size > _bestSize)
+        {
+          _bestSize = size;
+          _largestTreeRoot = StlBoolVector(_parent.size(), false);
+        }
+        if (size == _bestSize)
+        {
+          int root = std::find(_parent.begin(), _parent.end(), -1) - _parent.begin();
+          _largestTreeRoot[root] = true;
+        }
+      }
+      return;
+    }
+    
+    const Digraph& G = _G.getG();
+    const int j = _order[idx];
+    
+    _parent[j] = -2;
+    enumerate(idx + 1, rooted);
+    
+    if (!rooted)
+    {
+      _parent[j] = -1;
+      enumerate(idx + 1, true);
+    }
+    
+    for (InArcIt a(G, _G.mapColumnToNode(j)); a != lemon::INVALID; ++a)
+    {
+      int k = _G.mapNodeToColumn(G.source(a));
+      if (_parent[k] != -2)
+      {
+        _parent[j] = k;
+        enumerate(idx + 1, rooted);
+      }
+    }
+    
+    _parent[j] = -2;
+  }
+};
+
+} // namespace vaff
+
+#endif // TESTINSTANCE_H